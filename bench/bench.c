@@ -0,0 +1,410 @@
+/// @file bench.c
+/// @brief Time every entry point of student_api.h on a data file and write the results as JSON.
+/// Usage : bench <data file> <results file (.json)> [repetitions]\n
+/// Every timed function runs `repetitions` times; min, mean and max wall-clock durations are
+/// reported in seconds. Everything printed by the API (stdout) is discarded, only a summary is
+/// written on stderr. Display functions are not timed (they only measure the terminal).
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "student_api.h"
+
+/// @brief Maximum number of timed entries
+#define BENCH_MAX_RESULTS 32
+/// @brief Number of API_get_student_by_id (and API_get_weakest_course) calls timed in one
+/// repetition
+#define BENCH_N_LOOKUPS 100000
+/// @brief Maximum number of grade lines in the file given to API_apply_grades
+#define BENCH_N_APPLIED 10000
+/// @brief Key used by API_cipher / API_decipher (read from stdin, exactly KEY_SIZE characters)
+#define BENCH_KEY "bench-cipherkey!"
+
+/// @brief Timings of one entry point
+typedef struct bench_result
+{
+    const char *name; //!< Name of the timed entry (API function, with its parameters if any)
+    double min;       //!< Fastest run (s)
+    double sum;       //!< Sum of every run (s)
+    double max;       //!< Slowest run (s)
+    int n_runs;       //!< Number of runs
+} Bench_result;
+
+/// @brief Content of the data file needed by the benchmarks
+typedef struct data_info
+{
+    long n_students;       //!< Number of students
+    long n_courses;        //!< Number of courses
+    long n_grades;         //!< Number of grades
+    unsigned int *ids;     //!< Id of every student
+    char first_course[64]; //!< Name of the first course of the file
+} Data_info;
+
+static Bench_result results[BENCH_MAX_RESULTS];
+static int n_results = 0;
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/// @brief Add a run of the named entry (created on its first run)
+static void record(const char *name, double duration)
+{
+    int i = 0;
+    while (i < n_results && strcmp(results[i].name, name) != 0)
+    {
+        i++;
+    }
+    if (i == n_results)
+    {
+        if (n_results == BENCH_MAX_RESULTS)
+        {
+            fprintf(stderr, "too many benchmark entries\n");
+            exit(EXIT_FAILURE);
+        }
+        results[n_results++] = (Bench_result){.name = name, .min = duration, .max = duration};
+    }
+    Bench_result *res = &results[i];
+    res->min = duration < res->min ? duration : res->min;
+    res->max = duration > res->max ? duration : res->max;
+    res->sum += duration;
+    res->n_runs++;
+}
+
+/// @brief Free a table of names returned by the API
+static void free_names(char **names, long n)
+{
+    if (!names)
+    {
+        return;
+    }
+    for (long i = 0; i < n; i++)
+    {
+        free(names[i]);
+    }
+    free(names);
+}
+
+/// @brief Read the sizes, the student ids and the first course name of a data file
+static Data_info read_data_info(const char *path)
+{
+    FILE *file = fopen(path, "r");
+    if (!file)
+    {
+        perror(path);
+        exit(EXIT_FAILURE);
+    }
+    Data_info info = {0};
+    long ids_cap = 1024;
+    info.ids = malloc(ids_cap * sizeof(unsigned int));
+    char line[512];
+    int section = -1; // 0 : students, 1 : courses, 2 : grades
+    while (fgets(line, sizeof(line), file))
+    {
+        if (strcmp(line, "ETUDIANTS\n") == 0 || strcmp(line, "MATIERES\n") == 0 ||
+            strcmp(line, "NOTES\n") == 0)
+        {
+            section++;
+            if (!fgets(line, sizeof(line), file)) // skip the section header
+            {
+                break;
+            }
+            continue;
+        }
+        if (line[0] == '\n' || line[0] == '\r' || section < 0)
+        {
+            continue;
+        }
+        if (section == 0)
+        {
+            if (info.n_students == ids_cap)
+            {
+                ids_cap *= 2;
+                info.ids = realloc(info.ids, ids_cap * sizeof(unsigned int));
+            }
+            info.ids[info.n_students++] = (unsigned int)strtoul(line, NULL, 10);
+        }
+        else if (section == 1)
+        {
+            if (info.n_courses++ == 0)
+            {
+                size_t len = strcspn(line, ";");
+                len = len < sizeof(info.first_course) ? len : sizeof(info.first_course) - 1;
+                memcpy(info.first_course, line, len);
+                info.first_course[len] = '\0';
+            }
+        }
+        else
+        {
+            info.n_grades++;
+        }
+    }
+    fclose(file);
+    if (!info.ids || info.n_students < SIZE_TOP1 || info.n_courses == 0)
+    {
+        fprintf(stderr, "%s : at least %d students and one course are needed\n", path, SIZE_TOP1);
+        exit(EXIT_FAILURE);
+    }
+    return info;
+}
+
+/// @brief Write a grades file (id;nom;note lines) for API_apply_grades
+static void write_grades_file(const char *path, const Data_info *info)
+{
+    FILE *file = fopen(path, "w");
+    if (!file)
+    {
+        perror(path);
+        exit(EXIT_FAILURE);
+    }
+    long n = info->n_students < BENCH_N_APPLIED ? info->n_students : BENCH_N_APPLIED;
+    for (long i = 0; i < n; i++)
+    {
+        fprintf(file, "%u;%s;%ld.5\n", info->ids[i], info->first_course, i % 20);
+    }
+    fclose(file);
+}
+
+/// @brief Make the next API_cipher / API_decipher call read its key from a file
+static void feed_key(const char *key_path)
+{
+    if (!freopen(key_path, "r", stdin))
+    {
+        perror(key_path);
+        exit(EXIT_FAILURE);
+    }
+}
+
+/// @brief Write the results as JSON
+static void write_json(const char *path, const char *data_path, const Data_info *info, int reps)
+{
+    FILE *file = fopen(path, "w");
+    if (!file)
+    {
+        perror(path);
+        exit(EXIT_FAILURE);
+    }
+    fprintf(file, "{\n");
+    fprintf(file, "  \"data_file\": \"%s\",\n", data_path);
+    fprintf(file, "  \"n_students\": %ld,\n", info->n_students);
+    fprintf(file, "  \"n_courses\": %ld,\n", info->n_courses);
+    fprintf(file, "  \"n_grades\": %ld,\n", info->n_grades);
+    fprintf(file, "  \"repetitions\": %d,\n", reps);
+    fprintf(file, "  \"unit\": \"s\",\n");
+    fprintf(file, "  \"results\": [\n");
+    for (int i = 0; i < n_results; i++)
+    {
+        const Bench_result *res = &results[i];
+        fprintf(file,
+                "    {\"name\": \"%s\", \"runs\": %d, \"min\": %.9f, \"mean\": %.9f, "
+                "\"max\": %.9f}%s\n",
+                res->name, res->n_runs, res->min, res->sum / res->n_runs, res->max,
+                i + 1 < n_results ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+    fclose(file);
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 3 || argc > 4)
+    {
+        fprintf(stderr, "usage : %s <data file> <results file (.json)> [repetitions]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    char *data_path = argv[1];
+    int reps = argc == 4 ? atoi(argv[3]) : 5;
+    if (reps < 1)
+    {
+        fprintf(stderr, "repetitions must be positive\n");
+        return EXIT_FAILURE;
+    }
+    Data_info info = read_data_info(data_path);
+
+    // temporary files, next to the results
+    size_t path_len = strlen(argv[2]) + 16;
+    char *bin_path = malloc(path_len), *ciphered_path = malloc(path_len);
+    char *deciphered_path = malloc(path_len), *key_path = malloc(path_len);
+    char *grades_path = malloc(path_len);
+    snprintf(bin_path, path_len, "%s.bin", argv[2]);
+    snprintf(ciphered_path, path_len, "%s.bin.ciph", argv[2]);
+    snprintf(deciphered_path, path_len, "%s.bin.deciph", argv[2]);
+    snprintf(key_path, path_len, "%s.key", argv[2]);
+    snprintf(grades_path, path_len, "%s.grades", argv[2]);
+    write_grades_file(grades_path, &info);
+    FILE *key_file = fopen(key_path, "w");
+    if (!key_file)
+    {
+        perror(key_path);
+        return EXIT_FAILURE;
+    }
+    fprintf(key_file, "%s\n", BENCH_KEY);
+    fclose(key_file);
+
+    if (!freopen("/dev/null", "w", stdout)) // the API prints a lot, keep only the results
+    {
+        perror("/dev/null");
+        return EXIT_FAILURE;
+    }
+
+    static const struct
+    {
+        int mode;
+        const char *name;
+    } sort_modes[] = {{STUDENT_ID, "API_sort_students(STUDENT_ID)"},
+                      {ALPHA_FIRST_NAME, "API_sort_students(ALPHA_FIRST_NAME)"},
+                      {ALPHA_LAST_NAME, "API_sort_students(ALPHA_LAST_NAME)"},
+                      {AVERAGE, "API_sort_students(AVERAGE)"},
+                      {MINIMUM, "API_sort_students(MINIMUM)"}};
+
+    for (int r = 0; r < reps; r++)
+    {
+        double t0 = now();
+        CLASS_DATA *prom = API_load_students(data_path);
+        record("API_load_students", now() - t0);
+
+        t0 = now();
+        API_save_to_binary_file(prom, bin_path);
+        record("API_save_to_binary_file", now() - t0);
+
+        t0 = now();
+        char **best = API_get_best_students(prom);
+        record("API_get_best_students", now() - t0);
+        free_names(best, SIZE_TOP1);
+
+        t0 = now();
+        best = API_get_best_students_in_course(prom, info.first_course);
+        record("API_get_best_students_in_course", now() - t0);
+        free_names(best, SIZE_TOP2);
+
+        int top_1pc = (int)(info.n_students / 100); // top 1 % of the promotion
+        int n_best = 0;
+        t0 = now();
+        best = API_get_best_students_n(prom, top_1pc, &n_best);
+        record("API_get_best_students_n(1%)", now() - t0);
+        free_names(best, n_best);
+
+        t0 = now();
+        best = API_get_worst_students_n(prom, top_1pc, &n_best);
+        record("API_get_worst_students_n(1%)", now() - t0);
+        free_names(best, n_best);
+
+        t0 = now();
+        best = API_get_best_students_in_course_n(prom, info.first_course, top_1pc, &n_best);
+        record("API_get_best_students_in_course_n(1%)", now() - t0);
+        free_names(best, n_best);
+
+        t0 = now();
+        char ***best_per_course = API_get_best_students_all_courses(prom, SIZE_TOP2);
+        record("API_get_best_students_all_courses", now() - t0);
+        for (long c = 0; c < info.n_courses; c++)
+        {
+            free_names(best_per_course[c], SIZE_TOP2);
+        }
+        free(best_per_course);
+
+        // first course only (any promotion has it), the first call builds the validation bitmaps
+        t0 = now();
+        API_count_validated_students(prom, 1u);
+        record("API_count_validated_students", now() - t0);
+
+        int n_validated = 0;
+        t0 = now();
+        char **validated = API_get_validated_students(prom, 1u, &n_validated);
+        record("API_get_validated_students", now() - t0);
+        free_names(validated, n_validated);
+
+        int n_stats = 0;
+        t0 = now();
+        COURSE_STATS *stats = API_course_stats(prom, &n_stats);
+        record("API_course_stats", now() - t0);
+        free(stats);
+
+        t0 = now();
+        for (long i = 0; i < BENCH_N_LOOKUPS; i++)
+        {
+            free(API_get_student_by_id(prom, info.ids[i % info.n_students]));
+        }
+        record("API_get_student_by_id(x100000)", now() - t0);
+
+        t0 = now();
+        for (long i = 0; i < BENCH_N_LOOKUPS; i++)
+        {
+            float average = 0;
+            free(API_get_weakest_course(prom, info.ids[i % info.n_students], &average));
+        }
+        record("API_get_weakest_course(x100000)", now() - t0);
+
+        for (size_t m = 0; m < sizeof(sort_modes) / sizeof(sort_modes[0]); m++)
+        {
+            API_set_sorting_mode(prom, sort_modes[m].mode);
+            t0 = now();
+            char **sorted = API_sort_students(prom);
+            record(sort_modes[m].name, now() - t0);
+            free_names(sorted, SIZE_TOP1);
+        }
+
+        t0 = now(); // every mode again, the promotion didn't change
+        for (size_t m = 0; m < sizeof(sort_modes) / sizeof(sort_modes[0]); m++)
+        {
+            API_set_sorting_mode(prom, sort_modes[m].mode);
+            free_names(API_sort_students(prom), SIZE_TOP1);
+        }
+        record("API_sort_students(all modes, again)", now() - t0);
+
+        t0 = now();
+        API_apply_grades(prom, grades_path);
+        record("API_apply_grades", now() - t0);
+
+        API_set_sorting_mode(prom, AVERAGE); // the grades changed : nothing is sorted yet
+        t0 = now();
+        char **first = API_sort_students_n(prom, top_1pc);
+        record("API_sort_students_n(AVERAGE, 1%)", now() - t0);
+        free_names(first, top_1pc < info.n_students ? top_1pc : info.n_students);
+
+        t0 = now();
+        API_unload(prom);
+        record("API_unload", now() - t0);
+
+        t0 = now();
+        prom = API_restore_from_binary_file(bin_path);
+        record("API_restore_from_binary_file", now() - t0);
+        API_unload(prom);
+
+        feed_key(key_path);
+        t0 = now();
+        API_cipher(bin_path, ciphered_path);
+        record("API_cipher", now() - t0);
+
+        feed_key(key_path);
+        t0 = now();
+        API_decipher(ciphered_path, deciphered_path);
+        record("API_decipher", now() - t0);
+    }
+
+    write_json(argv[2], data_path, &info, reps);
+    for (int i = 0; i < n_results; i++)
+    {
+        fprintf(stderr, "%-40s %12.6f s\n", results[i].name, results[i].sum / results[i].n_runs);
+    }
+
+    remove(bin_path);
+    remove(ciphered_path);
+    remove(deciphered_path);
+    remove(key_path);
+    remove(grades_path);
+    free(bin_path);
+    free(ciphered_path);
+    free(deciphered_path);
+    free(key_path);
+    free(grades_path);
+    free(info.ids);
+    return EXIT_SUCCESS;
+}
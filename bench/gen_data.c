@@ -0,0 +1,151 @@
+/// @file gen_data.c
+/// @brief Generate a synthetic promotion in the text data format (see data/data.txt).
+/// Usage : gen_data <output file> <n_students> <n_courses> <grades per course> [seed]\n
+/// Every student gets <grades per course> grades in every course. Names are drawn from small pools
+/// (so they repeat like in real promotions) and the output only depends on the seed.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/// @brief Maximum number of courses (the validation bitmask of a student holds 32 bits)
+#define GEN_MAX_COURSES 31
+
+/// @brief First id given to a student
+#define GEN_FIRST_ID 100000000u
+
+static const char *first_names[] = {
+        "Alexander", "Clara",  "Felix",   "Isabella", "Hugo",     "Olivia",   "Sebastian",
+        "Laura",     "Emma",   "Thomas",  "Alice",    "Gabriel",  "Victoria", "Nikolai",
+        "Beatrice",  "Freya",  "Patrick", "Helena",   "Oscar",    "Edward",   "Zoe",
+        "Maria",     "Julian", "Sofia",   "Luca",     "Nora",     "Karl",     "Benjamin"};
+
+static const char *last_names[] = {
+        "Müller", "Rossi",    "Dubois",  "Ivanov",    "Larsen",  "Kowalski", "Moreau",
+        "Nielsen", "Schmidt", "Bianchi", "Petrov",    "Durand",  "Hansen",   "Varga",
+        "Ricci",  "Jensen",   "Horvath", "Popov",     "Fischer", "Martinez", "Schneider",
+        "Kovac",  "Lemoine",  "Andersson", "Matos",   "Weber",   "Meyer",    "Popescu"};
+
+static const char *course_names[] = {
+        "Allemand",  "Anglais",  "Arts Plastiques", "Biologie",    "Chimie",   "EPS",
+        "Economie",  "Espagnol", "Français",        "Geographie",  "Histoire", "Informatique",
+        "Latin",     "Mathematiques", "Musique",    "Philosophie", "Physique", "Sciences Sociales",
+        "Sociologie", "Technologie"};
+
+#define N_ELEMS(tab) (sizeof(tab) / sizeof((tab)[0]))
+
+/// @brief xorshift64 pseudo random generator (reproducible across platforms, unlike rand)
+static uint64_t rng_state = 88172645463325252ull;
+
+static uint64_t next_rand(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+/// @brief Random number in [0, n)
+static unsigned long rand_below(unsigned long n) { return (unsigned long)(next_rand() % n); }
+
+int main(int argc, char **argv)
+{
+    if (argc < 5 || argc > 6)
+    {
+        fprintf(stderr, "usage : %s <output file> <n_students> <n_courses> <grades per course> "
+                        "[seed]\n",
+                argv[0]);
+        return EXIT_FAILURE;
+    }
+    long n_students = strtol(argv[2], NULL, 10);
+    long n_courses = strtol(argv[3], NULL, 10);
+    long n_grades = strtol(argv[4], NULL, 10);
+    if (argc == 6)
+    {
+        rng_state = strtoull(argv[5], NULL, 10) | 1; // state must not be 0
+    }
+    if (n_students < 1 || n_students > 100000000 || n_courses < 1 ||
+        n_courses > GEN_MAX_COURSES || n_grades < 1)
+    {
+        fprintf(stderr, "invalid parameters (1 <= n_students <= 1e8, 1 <= n_courses <= %d, "
+                        "grades per course >= 1)\n",
+                GEN_MAX_COURSES);
+        return EXIT_FAILURE;
+    }
+    FILE *file = fopen(argv[1], "w");
+    if (!file)
+    {
+        perror("fopen");
+        return EXIT_FAILURE;
+    }
+    static char file_buf[1 << 20]; // bigger stdio buffer, the output may be huge
+    setvbuf(file, file_buf, _IOFBF, sizeof(file_buf));
+
+    // students are written in a shuffled order (the loader sorts them by id)
+    unsigned int *ids = malloc(n_students * sizeof(unsigned int));
+    if (!ids)
+    {
+        fprintf(stderr, "malloc error\n");
+        return EXIT_FAILURE;
+    }
+    for (long i = 0; i < n_students; i++)
+    {
+        ids[i] = GEN_FIRST_ID + (unsigned int)i * 7u;
+    }
+    for (long i = n_students - 1; i > 0; i--)
+    {
+        long j = (long)rand_below(i + 1);
+        unsigned int tmp = ids[i];
+        ids[i] = ids[j];
+        ids[j] = tmp;
+    }
+
+    fprintf(file, "ETUDIANTS\nnumero;prenom;nom;age\n");
+    for (long i = 0; i < n_students; i++)
+    {
+        fprintf(file, "%u;%s;%s;%lu\n", ids[i], first_names[rand_below(N_ELEMS(first_names))],
+                last_names[rand_below(N_ELEMS(last_names))], 17 + rand_below(9));
+    }
+
+    fprintf(file, "\n\nMATIERES\nnom;coef\n");
+    for (long c = 0; c < n_courses; c++)
+    {
+        unsigned long coef = 4 + rand_below(9); // coef between 1.00 and 3.00, by quarters
+        if ((size_t)c < N_ELEMS(course_names))
+        {
+            fprintf(file, "%s;%lu.%02lu\n", course_names[c], coef / 4, coef % 4 * 25);
+        }
+        else
+        {
+            fprintf(file, "Option %ld;%lu.%02lu\n", c, coef / 4, coef % 4 * 25);
+        }
+    }
+
+    fprintf(file, "\n\nNOTES\nid;nom;note\n");
+    for (long g = 0; g < n_grades; g++)
+    {
+        for (long i = 0; i < n_students; i++)
+        {
+            for (long c = 0; c < n_courses; c++)
+            {
+                unsigned long grade = rand_below(201); // tenths of point, in [0, 20]
+                if ((size_t)c < N_ELEMS(course_names))
+                {
+                    fprintf(file, "%u;%s;%lu.%lu\n", ids[i], course_names[c], grade / 10,
+                            grade % 10);
+                }
+                else
+                {
+                    fprintf(file, "%u;Option %ld;%lu.%lu\n", ids[i], c, grade / 10, grade % 10);
+                }
+            }
+        }
+    }
+    free(ids);
+    if (fclose(file) != 0)
+    {
+        perror("fclose");
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
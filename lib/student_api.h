@@ -28,12 +28,46 @@ typedef void CLASS_DATA;
 ///@brief Sorting mode: by student minimum grade (highest to lowest)
 #define MINIMUM 4
 
+/// @brief Statistics of the averages of the students in a course (see API_course_stats). Students
+/// without grades in the course are not counted.
+typedef struct
+{
+    ///@brief name of the course (owned by the promotion)
+    const char *course;
+    ///@brief number of students with an average in the course
+    int count;
+    ///@brief mean of the averages (-1 if count is 0)
+    float mean;
+    ///@brief variance of the averages (0 if count is 0)
+    float variance;
+    ///@brief lowest average (-1 if count is 0)
+    float min;
+    ///@brief highest average (-1 if count is 0)
+    float max;
+    ///@brief share of the students having validated the course (between 0 and 1)
+    float pass_rate;
+    ///@brief median of the averages (-1 if count is 0)
+    float median;
+    ///@brief first decile, first quartile, third quartile and last decile of the averages (-1 if
+    /// count is 0)
+    float percentile_10, percentile_25, percentile_75, percentile_90;
+} COURSE_STATS;
+
 /// @brief Load data from a formatted **text file** and create a Promotion structure
 /// Load order : courses, students, grades
 /// @param file_path the path to the data file
 /// @return the loaded Promotion
 CLASS_DATA *API_load_students(char *file_path);
 
+/// @brief Add the grades of a **text file** to an already loaded promotion. Averages and validation
+/// results are updated in O(1) per grade (no full re-evaluation).
+/// The file contains grade lines (id;nom;note), optionally preceded by the NOTES section header, or
+/// is a full data file (only its NOTES section is read).
+/// @param pClass the promotion
+/// @param file_path the path to the grades file
+/// @return the number of grades added
+int API_apply_grades(CLASS_DATA *pClass, char *file_path);
+
 /// @brief Saves a promotion to a binary file. Order: courses, students
 /// @param pClass the promotion to save
 /// @param file_path the path to the binary file
@@ -66,21 +100,110 @@ char **API_get_best_students(CLASS_DATA *pClass);
 /// course, NULL if the course isn't found.
 char **API_get_best_students_in_course(CLASS_DATA *pClass, char *course);
 
+/// @brief Get the k best students from a promotion (bounded heap, O(n log k))
+/// @param pClass the promotion
+/// @param k the number of students wanted
+/// @param size receives the number of names returned : min(k, number of students)
+/// @return a dynamic table containing the names of the size best students, the best first
+char **API_get_best_students_n(CLASS_DATA *pClass, int k, int *size);
+
+/// @brief Get the k students with the lowest general average from a promotion (students without
+/// grades first)
+/// @param pClass the promotion
+/// @param k the number of students wanted
+/// @param size receives the number of names returned : min(k, number of students)
+/// @return a dynamic table containing the names of the size students, the lowest average first
+char **API_get_worst_students_n(CLASS_DATA *pClass, int k, int *size);
+
+/// @brief Get the k best students from a promotion for a given course
+/// @param pClass the promotion
+/// @param course the course to rank students in
+/// @param k the number of students wanted
+/// @param size receives the number of names returned : min(k, number of students), 0 if the course
+/// isn't found
+/// @return a dynamic table containing the names of the size best students in course, the best
+/// first. NULL if the course isn't found.
+char **API_get_best_students_in_course_n(CLASS_DATA *pClass, char *course, int k, int *size);
+
+/// @brief Get the k best students of every course of a promotion, in a single pass over the
+/// students (faster than API_get_best_students_in_course_n for each course)
+/// @param pClass the promotion
+/// @param k the number of students wanted per course
+/// @return a table with one entry per course, in the order of the courses of the promotion
+/// (alphabetical) : a dynamic table containing the names of the min(k, number of students) best
+/// students in this course, the best first
+char ***API_get_best_students_all_courses(CLASS_DATA *pClass, int k);
+
+/// @brief Get a student from a promotion given its id (O(1) on average, whatever the sorting mode)
+/// @param pClass the promotion
+/// @param id the id of the student
+/// @return the name and first name of the student (dynamically allocated, must be freed by the
+/// caller), NULL if there is no student with this id
+char *API_get_student_by_id(CLASS_DATA *pClass, unsigned int id);
+
+/// @brief Get the weakest course of a student : the course with its lowest average (courses
+/// without grades count as -1), read from the cached minimum in O(1)
+/// @param pClass the promotion
+/// @param id the id of the student
+/// @param average receives the average of the student in this course, can be NULL
+/// @return the name of the course (dynamically allocated, must be freed by the caller), NULL if
+/// there is no student with this id or if they follow no course
+char *API_get_weakest_course(CLASS_DATA *pClass, unsigned int id, float *average);
+
 /// @brief Set the sorting mode for students in the promotion
 /// @param pClass the promotion
 /// @param mode the sorting mode (STUDENT_ID, ALPHA_FIRST_NAME, ALPHA_LAST_NAME, AVERAGE, MINIMUM)
 /// @return 1 if successful, 0 if the mode is incorrect
 int API_set_sorting_mode(CLASS_DATA *pClass, int mode);
 
-/// @brief Sort the students in the promotion according to the current sorting mode
+/// @brief Sort the students in the promotion according to the current sorting mode. The order of
+/// the promotion itself (displays, binary files) is not changed, and the sort of each mode is
+/// reused until the promotion is modified.
 /// @param pClass the promotion
-/// @return a dynamic table containing the names of all students sorted
+/// @return a dynamic table containing the names of the min(SIZE_TOP1, number of students) first
+/// students sorted
 char **API_sort_students(CLASS_DATA *pClass);
 
+/// @brief Get the k first students in the promotion according to the current sorting mode. Only
+/// these students are sorted when k is small compared to the size of the promotion.
+/// @param pClass the promotion
+/// @param k the number of students wanted
+/// @return a dynamic table containing the names of the min(k, number of students) first students
+char **API_sort_students_n(CLASS_DATA *pClass, int k);
+
 /// @brief Display the results of students per field (courses)
 /// @param pClass the promotion
 void API_display_results_per_field(CLASS_DATA *pClass);
 
+/// @brief Count the students who validated every course of a bitmask. Validations are read from
+/// per-course bitmaps, 64 students at a time.
+/// @param pClass the promotion
+/// @param courses_mask the courses : bit i for the i-th course of the promotion (e.g.
+/// SCIENCES_MASK or HUMANITIES_MASK), 0 matches every student
+/// @return the number of students
+int API_count_validated_students(CLASS_DATA *pClass, unsigned int courses_mask);
+
+/// @brief Get the students who validated every course of a bitmask (see
+/// API_count_validated_students)
+/// @param pClass the promotion
+/// @param courses_mask the courses
+/// @param size receives the number of students
+/// @return a dynamic table containing the names of these students, in the order of their ids
+char **API_get_validated_students(CLASS_DATA *pClass, unsigned int courses_mask, int *size);
+
+/// @brief Display the number of students who validated each field (sciences, humanities) and
+/// each course
+/// @param pClass the promotion
+void API_display_validation_summary(CLASS_DATA *pClass);
+
+/// @brief Compute the statistics of every course of a promotion, in a single pass over the
+/// averages of the students. Percentiles are read from a histogram of 0.05 point bins.
+/// @param pClass the promotion
+/// @param n_courses receives the number of courses
+/// @return a dynamic table containing the statistics of each course, in the order of the courses
+/// of the promotion (to free with free)
+COURSE_STATS *API_course_stats(CLASS_DATA *pClass, int *n_courses);
+
 /// @brief Cipher a file
 /// @param pIn the input file path (file to cipher)
 /// @param pOut the output file path (ciphered file path)
@@ -14,7 +14,7 @@ Course *bin_load_course(FILE *file)
     return cr;
 }
 
-Student *bin_load_student(FILE *file)
+Student *bin_load_student(FILE *file, Arena *arena, String_pool *names)
 {
     assert(file);
     unsigned int id = 0;
@@ -35,30 +35,67 @@ Student *bin_load_student(FILE *file)
            "couldn't load student number of courses (int) while loading student from binary");
     verify(fread(&(age), sizeof(int), 1, file) == 1,
            "couldn't load student age (int) while loading student from binary");
-    Student *stu = init_student(name, fname, id, n_courses, age);
+    Student *stu = init_student(name, fname, id, n_courses, age, arena, names);
     assert(stu);
     stu->average = avg;
     for (int i = 0; i < n_courses; i++)
     {
-        stu->f_courses[i] = bin_load_followed_course(file);
-        assert(stu->f_courses[i]);
+        bin_load_followed_course(file, &stu->f_courses[i], arena);
     }
+    reset_student_min_course_avg(stu);
     assert(student_is_valid(stu));
     return stu;
 }
 
-Followed_course *bin_load_followed_course(FILE *file)
+/// @brief Loads the grades table of a followed course (format of Grades_save_to_bin). The
+/// saved capacity is ignored : the table is allocated at its exact size (or stays inline).
+static void bin_load_grades(FILE *file, Followed_course *fcourse, Arena *arena)
 {
-    assert(file);
+    int capacity = 0;
+    int size = 0;
+    verify(fread(&capacity, sizeof(int), 1, file) == 1,
+           "couldn't load dynamic table capacity (int) while loading from binary");
+    verify(fread(&size, sizeof(int), 1, file) == 1,
+           "couldn't load dynamic table size (int) while loading from binary");
+    verify(size >= 0 && capacity >= size, "invalid grades table size while loading from binary");
+    followed_course_reserve(fcourse, size, arena);
+    Grades *grades = &fcourse->grades;
+    verify(fread(grades->tab, sizeof(grade_t), size, file) == (size_t)size,
+           "couldn't load dynamic table content while loading from binary");
+    grades->size = size;
+}
+
+void bin_load_followed_course(FILE *file, Followed_course *fcourse, Arena *arena)
+{
+    assert(file && fcourse);
     float avg = -1;
     verify(fread(&(avg), sizeof(float), 1, file) == 1,
            "couldn't load followed course average (float) while loading followed course from "
            "binary");
-    Followed_course *fcourse = init_followed_course(NULL);
-    assert(fcourse);
+    init_followed_course_in_place(fcourse);
     fcourse->average = avg;
-    fcourse->grades = Grades_load_from_bin(file, NULL);
-    assert(fcourse->grades);
+    bin_load_grades(file, fcourse, arena);
+    // running sum isn't saved
+    fcourse->grades_sum = sum_grades(fcourse->grades.tab, fcourse->grades.size);
     assert(followed_course_is_valid(fcourse));
-    return fcourse;
-}
\ No newline at end of file
+}
+
+StudentsTab *bin_load_student_tab(FILE *file, Arena *arena, String_pool *names)
+{
+    assert(file);
+    int capacity = 0;
+    int size = 0;
+    verify(fread(&capacity, sizeof(int), 1, file) == 1,
+           "couldn't load dynamic table capacity (int) while loading from binary");
+    verify(fread(&size, sizeof(int), 1, file) == 1,
+           "couldn't load dynamic table size (int) while loading from binary");
+    verify(size >= 0 && capacity >= size, "invalid students table size while loading from binary");
+    StudentsTab *stu_dtab = StudentsTab_init();
+    StudentsTab_reserve(stu_dtab, size); // the saved capacity is ignored (no slack)
+    for (int i = 0; i < size; i++)
+    {
+        stu_dtab->tab[i] = bin_load_student(file, arena, names);
+        stu_dtab->size++;
+    }
+    return stu_dtab;
+}
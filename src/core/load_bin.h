@@ -16,12 +16,23 @@ Course *bin_load_course(FILE *file);
 /// @brief Loads a student from a binary file. Order: id, name, fname, average, n_courses, followed
 /// courses
 /// @param file the binary file
+/// @param arena the arena to allocate the student in, NULL to use malloc
+/// @param names the pool to intern the names in (allocated in arena), NULL to copy them
 /// @return the loaded Student
-Student *bin_load_student(FILE *file);
+Student *bin_load_student(FILE *file, Arena *arena, String_pool *names);
 
-/// @brief Loads a followed course from a binary file. Order: average, grades
+/// @brief Loads a followed course from a binary file, in place (in the f_courses table of a
+/// student). Order: average, grades
 /// @param file the binary file
-/// @return the loaded Followed_course
-Followed_course *bin_load_followed_course(FILE *file);
+/// @param fcourse the followed course to load into
+/// @param arena the arena to allocate the grades in, NULL to use malloc
+void bin_load_followed_course(FILE *file, Followed_course *fcourse, Arena *arena);
+
+/// @brief Loads a students table from a binary file (same format as StudentsTab_load_from_bin)
+/// @param file the binary file
+/// @param arena the arena to allocate the students in, NULL to use malloc
+/// @param names the pool to intern the names in (allocated in arena), NULL to copy them
+/// @return the loaded StudentsTab
+StudentsTab *bin_load_student_tab(FILE *file, Arena *arena, String_pool *names);
 
 #endif
\ No newline at end of file
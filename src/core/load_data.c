@@ -3,7 +3,57 @@
 #include <errno.h>
 #include <stdio.h>
 
-StudentsTab *load_student_tab_data(FILE *file)
+DEFINE_DYN_TABLE(Grade_entry, GradeEntries)
+
+void add_grade_entries(GradeEntries *const tables[], int n_tables, Arena *arena)
+{
+    assert(tables && n_tables > -1);
+#ifndef NDEBUG
+    for (int t = 0; t < n_tables; t++)
+    {
+        for (int i = 0; i < tables[t]->size; i++)
+        {
+            Grade_entry *e = &tables[t]->tab[i];
+            assert(e->stu->f_courses[e->course_index].grades.size == 0);
+        }
+    }
+#endif
+    // first pass : count the grades of each followed course
+    for (int t = 0; t < n_tables; t++)
+    {
+        for (int i = 0; i < tables[t]->size; i++)
+        {
+            Grade_entry *e = &tables[t]->tab[i];
+            e->stu->f_courses[e->course_index].grades.size++;
+        }
+    }
+    // second pass : allocate each table once (on its first entry, the count is then reset)
+    for (int t = 0; t < n_tables; t++)
+    {
+        for (int i = 0; i < tables[t]->size; i++)
+        {
+            Grade_entry *e = &tables[t]->tab[i];
+            Followed_course *fcourse = &e->stu->f_courses[e->course_index];
+            int count = fcourse->grades.size;
+            if (count > 0)
+            {
+                fcourse->grades.size = 0;
+                followed_course_reserve(fcourse, count, arena);
+            }
+        }
+    }
+    // last pass : push the grades in file order
+    for (int t = 0; t < n_tables; t++)
+    {
+        for (int i = 0; i < tables[t]->size; i++)
+        {
+            Grade_entry *e = &tables[t]->tab[i];
+            add_grade_to_student_by_index(e->stu, e->course_index, e->grade, arena);
+        }
+    }
+}
+
+StudentsTab *load_student_tab_data(FILE *file, Arena *arena, String_pool *names)
 {
     // "if it work, don't fix it"
     assert(file);
@@ -22,12 +72,13 @@ StudentsTab *load_student_tab_data(FILE *file)
     {
         // we don't know the number of courses yet
         verify(age_is_valid(age), "invalid age while loading student data from text file");
-        Student *stu = init_student(name, fname, stu_id, 0, age);
+        Student *stu = init_student(name, fname, stu_id, 0, age, arena, names);
         assert(student_is_valid(stu));
         StudentsTab_push(stu, stu_dtab);
     }
     assert(!feof(file) && !ferror(file));
-    StudentsTab_sort(stu_dtab, compare_student_id);
+    StudentsTab_shrink_to_fit(stu_dtab); // the number of students isn't known beforehand
+    StudentsTab_sort_by_id(stu_dtab);
     return stu_dtab;
 }
 
@@ -71,8 +122,10 @@ void load_grades_data(Promotion *prom, FILE *file)
 {
     // TODO : are the asserts ok in this function ?
     assert(file && prom);
-    StudentsTab *stu_dtab = prom->stu_dtab;
-    CoursesTab *courses = prom->courses;
+    assert(prom->course_lookup && prom->stu_index);
+    promotion_grades_changed(prom);
+    // grades are pushed once all are read, in tables allocated at their exact size
+    GradeEntries *entries = GradeEntries_init();
     // data format is id;nom;note
     char buf[BUF_LEN];
     while (fgets(buf, BUF_LEN, file) == buf && isdigit(*buf))
@@ -101,40 +154,22 @@ void load_grades_data(Promotion *prom, FILE *file)
         p++;
 
         // parse grade (float)
-        int sign = 1;
-        if (*p == '-')
-        {
-            sign = -1;
-            p++;
-        }
-
-        float int_part = 0;
-        while (*p >= '0' && *p <= '9')
-        {
-            int_part = int_part * 10 + (*p - '0');
-            p++;
-        }
-
-        float frac_part = 0;
-        float base = 0.1f;
-        if (*p == '.')
-        {
-            p++;
-            while (*p >= '0' && *p <= '9')
-            {
-                frac_part += (*p - '0') * base;
-                base *= 0.1f;
-                p++;
-            }
-        }
-        float grade = sign * (int_part + frac_part);
-        verify(grade_is_valid(grade), "invalid grade while loading grades data from text file");
+        const char *cursor = p;
+        grade_t grade = 0;
+        verify(parse_grade(&cursor, buf + BUF_LEN, &grade),
+               "invalid grade while loading grades data from text file");
         // applying modifications
-        Student *stu = student_tab_bsearch(stu_dtab, id);
-        assert(stu);
-        add_grade_to_student(stu, courses, course_name, grade);
+        Student *stu = student_index_find(prom->stu_index, id);
+        verify(stu, "unknown student id while loading grades data from text file");
+        int course_index =
+                course_lookup_find(prom->course_lookup, course_name, strlen(course_name));
+        verify(course_index > -1, "course not found in courses table");
+        GradeEntries_push((Grade_entry){.stu = stu, .course_index = course_index, .grade = grade},
+                          entries);
     }
     verify(!ferror(file), "Error occurred while reading grades from text file");
+    add_grade_entries(&entries, 1, prom->arena);
+    GradeEntries_free(entries, NULL);
     // updating grades avg :
     evaluate_all_student_average(prom);
 }
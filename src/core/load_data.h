@@ -18,17 +18,124 @@ typedef struct sect
 #define SECTION_CONTENT                                                                            \
     {"ETUDIANTS", "numero;prenom;nom;age"}, {"MATIERES", "nom;coef"}, {"NOTES", "id;nom;note"}
 
+/// @brief Parse a grade written as "[-]int[.frac]" and move the cursor right after it.
+/// Shared by the text loaders so that every loading path gives bit-identical grades.
+/// In fixed point mode (FIXED_POINT_GRADES), the grade is parsed directly in tenths of point
+/// (rounded to the nearest tenth if more decimals are given).
+/// @param cursor pointer to the current parsing position, updated past the parsed grade
+/// @param end end of the readable buffer (parsing never goes past it)
+/// @param grade receives the parsed grade
+/// @return true if the grade is valid (invalidity reasons are printed to stderr)
+static inline bool parse_grade(const char **cursor, const char *end, grade_t *grade)
+{
+    const char *p = *cursor;
+    int sign = 1;
+    if (p < end && *p == '-')
+    {
+        sign = -1;
+        p++;
+    }
+#ifdef FIXED_POINT_GRADES
+#if GRADE_SCALE != 10
+#error "the fixed point grade parser expects tenths of point (GRADE_SCALE == 10)"
+#endif
+    unsigned long units = 0;
+    while (p < end && *p >= '0' && *p <= '9')
+    {
+        if (units <= GRADE_FIXED_MAX) // saturate, anything bigger is invalid anyway
+        {
+            units = units * 10 + (*p - '0');
+        }
+        p++;
+    }
+    units *= GRADE_SCALE;
+    if (p < end && *p == '.')
+    {
+        p++;
+        if (p < end && *p >= '0' && *p <= '9') // tenths
+        {
+            units += *p - '0';
+            p++;
+        }
+        if (p < end && *p >= '5' && *p <= '9') // round to the nearest tenth
+        {
+            units++;
+        }
+        while (p < end && *p >= '0' && *p <= '9')
+        {
+            p++;
+        }
+    }
+    *cursor = p;
+    if ((sign < 0 && units > 0) || units > GRADE_FIXED_MAX || (long)units < GRADE_FIXED_MIN)
+    {
+        fprintf(stderr,
+                BOLD_RED "ERROR : grade value %s%lu/%d is invalid (GRADE_FIXED_MIN = %d, "
+                         "GRADE_FIXED_MAX = %d)\n" RESET,
+                sign < 0 ? "-" : "", units, GRADE_SCALE, GRADE_FIXED_MIN, GRADE_FIXED_MAX);
+        return false;
+    }
+    *grade = (grade_t)units;
+    return true;
+#else
+    float int_part = 0;
+    while (p < end && *p >= '0' && *p <= '9')
+    {
+        int_part = int_part * 10 + (*p - '0');
+        p++;
+    }
+
+    float frac_part = 0;
+    float base = 0.1f;
+    if (p < end && *p == '.')
+    {
+        p++;
+        while (p < end && *p >= '0' && *p <= '9')
+        {
+            frac_part += (*p - '0') * base;
+            base *= 0.1f;
+            p++;
+        }
+    }
+    *cursor = p;
+    *grade = sign * (int_part + frac_part);
+    return grade_is_valid(*grade);
+#endif
+}
+
+/// @brief A parsed grade, waiting to be pushed in its followed course
+typedef struct grade_entry
+{
+    Student *stu;     //!< The student the grade belongs to
+    int course_index; //!< Index of the course in the courses table
+    grade_t grade;    //!< The grade value
+} Grade_entry;
+
+DECLARE_DYN_TABLE(Grade_entry, GradeEntries)
+
+/// @brief Push parsed grades in their followed courses, table after table (file order is kept).
+/// The grades of each followed course are counted first, and its table is allocated once at its
+/// exact size : the followed courses must have no grade yet (their size is used as a counter).
+/// @param tables the tables of parsed grades, in file order
+/// @param n_tables the number of tables
+/// @param arena the arena owning the students, NULL if they are allocated with malloc
+void add_grade_entries(GradeEntries *const tables[], int n_tables, Arena *arena);
+
 /// @brief Load the students data from a file
 /// @param file the file to read from
+/// @param arena the arena to allocate the students in, NULL to use malloc
+/// @param names the pool to intern the names in (allocated in arena), NULL to copy them
 /// @return the loaded StudentsTab
-StudentsTab *load_student_tab_data(FILE *file);
+StudentsTab *load_student_tab_data(FILE *file, Arena *arena, String_pool *names);
 
 /// @brief Load the courses data from a file
 /// @param file the file to read from
 /// @return the loaded CoursesTab
 CoursesTab *load_courses_data(FILE *file);
 
-/// @brief Load the grades data from a file and update the students' followed courses (and their averages)
+/// @brief Load the grades data from a file and update the students' followed courses (and their averages).
+/// Grades are read first, then pushed in tables allocated at their exact size (see
+/// add_grade_entries) : the students must have no grade yet.
 /// @param prom the promotion struct containing students and courses tables
 /// @param file the file to read from
 void load_grades_data(Promotion* prom, FILE *file);
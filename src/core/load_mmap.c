@@ -0,0 +1,553 @@
+#include "load_mmap.h"
+#include "../other/simd_scan.h"
+#include "../other/threads.h"
+#include <ctype.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/// @brief Get the end of the line starting at p (position of '\n', or end if last line)
+static inline const char *find_eol(const char *p, const char *end)
+{
+    const char *eol = memchr(p, '\n', end - p);
+    return eol ? eol : end;
+}
+
+/// @brief Count the lines of [begin, end), an upper bound of the number of records they hold
+static inline int count_lines(const char *begin, const char *end)
+{
+    int n_lines = 0;
+    for (const char *p = begin; p < end; p = find_eol(p, end) + 1)
+    {
+        n_lines++;
+    }
+    return n_lines;
+}
+
+/// @brief Check if the line [line, eol) is exactly str
+static inline bool line_equals(const char *line, const char *eol, const char *str)
+{
+    size_t len = strlen(str);
+    return (size_t)(eol - line) == len && memcmp(line, str, len) == 0;
+}
+
+/// @brief Parse an unsigned int, return the position after it (or p if there is no digit)
+static inline const char *parse_uint(const char *p, const char *end, unsigned int *val)
+{
+    //! WARNING NO OUT OF UNSIGNED INT RANGE DETECTION
+    unsigned int res = 0;
+    while (p < end && *p >= '0' && *p <= '9')
+    {
+        res = res * 10 + (*p - '0');
+        p++;
+    }
+    *val = res;
+    return p;
+}
+
+/// @brief Copy the field [begin, end) in buf as a null terminated string
+static inline void copy_field(char buf[], const char *begin, const char *end)
+{
+    size_t len = end - begin;
+    verify(len < BUF_LEN, "field too long while loading data from text file");
+    memcpy(buf, begin, len);
+    buf[len] = '\0';
+}
+
+Mapped_file map_data_file(const char *file_path)
+{
+    assert(file_path);
+    Mapped_file mfile = {.data = NULL, .len = 0};
+    int fd = open(file_path, O_RDONLY);
+    if (fd < 0)
+    {
+        fprintf(stderr, "Erreur : %s inexistant.\n", file_path);
+        exit(EXIT_FAILURE);
+    }
+    struct stat st;
+    verify(fstat(fd, &st) == 0, "fstat failed");
+    mfile.len = (size_t)st.st_size;
+    if (mfile.len > 0) // mmap refuses empty mappings
+    {
+        void *data = mmap(NULL, mfile.len, PROT_READ, MAP_PRIVATE, fd, 0);
+        verify(data != MAP_FAILED, "mmap failed");
+        madvise(data, mfile.len, MADV_SEQUENTIAL); // only a hint, failure is harmless
+        mfile.data = data;
+    }
+    close(fd); // the mapping stays valid after closing the file descriptor
+    return mfile;
+}
+
+void unmap_data_file(Mapped_file *mfile)
+{
+    assert(mfile);
+    if (mfile->data)
+    {
+        verify(munmap((void *)mfile->data, mfile->len) == 0, "munmap failed");
+    }
+    mfile->data = NULL;
+    mfile->len = 0;
+}
+
+void locate_sections(const Mapped_file *mfile, const Section sections[], int n_sections,
+                     Section_span spans[])
+{
+    assert(mfile && sections && spans && n_sections > 0);
+    const char *p = mfile->data;
+    const char *end = mfile->data + mfile->len;
+    for (int i = 0; i < n_sections; i++)
+    {
+        // find the section title
+        bool found = false;
+        while (p < end && !found)
+        {
+            const char *eol = find_eol(p, end);
+            if (line_equals(p, eol, sections[i].section_title))
+            {
+                found = true;
+                if (i > 0)
+                {
+                    spans[i - 1].end = p; // previous section stops at this title
+                }
+            }
+            p = eol < end ? eol + 1 : end;
+        }
+        if (!found)
+        {
+            printf(BOLD_RED "ERROR : end of file reached while looking for section title %s.\n"
+                            RESET,
+                   sections[i].section_title);
+            exit(EXIT_FAILURE);
+        }
+        // find the section header
+        found = false;
+        while (p < end && !found)
+        {
+            const char *eol = find_eol(p, end);
+            found = line_equals(p, eol, sections[i].section_header);
+            p = eol < end ? eol + 1 : end;
+        }
+        if (!found)
+        {
+            printf(BOLD_RED "ERROR : end of file reached while looking for section header %s.\n"
+                            RESET,
+                   sections[i].section_header);
+            exit(EXIT_FAILURE);
+        }
+        spans[i].begin = p;
+    }
+    spans[n_sections - 1].end = end;
+}
+
+StudentsTab *mmap_load_student_tab_data(Section_span span, Arena *arena, String_pool *names)
+{
+    assert(span.begin && span.begin <= span.end);
+    char name[BUF_LEN];
+    char fname[BUF_LEN];
+    StudentsTab *stu_dtab = StudentsTab_init();
+    StudentsTab_reserve(stu_dtab, count_lines(span.begin, span.end));
+    const char *p = span.begin;
+    while (p < span.end)
+    {
+        // data format is numero;prenom;nom;age
+        const char *fields[4];
+        const char *eol = NULL;
+        int n_fields = scan_line_fields(p, span.end, fields, 4, &eol);
+        const char *next = eol < span.end ? eol + 1 : span.end;
+        if (p == eol) // empty lines are skipped (like fscanf does)
+        {
+            p = next;
+            continue;
+        }
+        unsigned int stu_id = 0;
+        const char *fname_begin = fields[0] + 1;
+        const char *name_begin = fields[1] + 1;
+        const char *age_begin = fields[2] + 1;
+        if (n_fields < 4 || parse_uint(p, fields[0], &stu_id) != fields[0] || p == fields[0] ||
+            fname_begin == fields[1] || name_begin == fields[2])
+        {
+            break; // not a student line
+        }
+        int sign = 1;
+        if (age_begin < eol && *age_begin == '-')
+        {
+            sign = -1;
+            age_begin++;
+        }
+        unsigned int abs_age = 0;
+        if (parse_uint(age_begin, fields[3], &abs_age) == age_begin)
+        {
+            break;
+        }
+        int age = sign * (int)abs_age;
+        verify(age_is_valid(age), "invalid age while loading student data from text file");
+        copy_field(fname, fname_begin, fields[1]);
+        copy_field(name, name_begin, fields[2]);
+        // we don't know the number of courses yet
+        Student *stu = init_student(name, fname, stu_id, 0, age, arena, names);
+        assert(student_is_valid(stu));
+        StudentsTab_push(stu, stu_dtab);
+        p = next;
+    }
+    StudentsTab_sort_by_id(stu_dtab);
+    return stu_dtab;
+}
+
+CoursesTab *mmap_load_courses_data(Section_span span)
+{
+    assert(span.begin && span.begin <= span.end);
+    CoursesTab *courses = CoursesTab_init();
+    char course_name[BUF_LEN];
+    char coef_buf[BUF_LEN];
+    const char *p = span.begin;
+    while (p < span.end)
+    {
+        // data format is nom;coef
+        const char *fields[2];
+        const char *eol = NULL;
+        int n_fields = scan_line_fields(p, span.end, fields, 2, &eol);
+        if (n_fields < 2 || fields[0] == p)
+        {
+            break; // not a course line
+        }
+        // strtof needs a null terminated string, and the mapping isn't
+        copy_field(coef_buf, fields[0] + 1, eol);
+        char *coef_end = NULL;
+        float coef = strtof(coef_buf, &coef_end);
+        if (coef_end == coef_buf)
+        {
+            break;
+        }
+        copy_field(course_name, p, fields[0]);
+        Course *cr = init_course(coef, course_name);
+        assert(course_is_valid(cr));
+        CoursesTab_push(cr, courses);
+        p = eol < span.end ? eol + 1 : span.end;
+    }
+    CoursesTab_sort(courses, compare_courses); // sort alphabetically
+    return courses;
+}
+
+/// @brief Read a grade line "id;nom;note" without exiting if it is invalid
+/// @param p first byte of the line
+/// @param end end of the readable buffer
+/// @param eol receives the end of the line
+/// @param id receives the student id
+/// @param lookup the courses name lookup table
+/// @param course_index receives the index of the course in the courses table
+/// @param grade receives the parsed (and validated) grade
+/// @return NULL if the line is valid, the reason why it isn't otherwise
+static const char *read_grade_line(const char *p, const char *end, const char **eol,
+                                   unsigned int *id, const Course_lookup *lookup,
+                                   int *course_index, grade_t *grade)
+{
+    const char *fields[3];
+    int n_fields = scan_line_fields(p, end, fields, 3, eol);
+    if (n_fields != 3)
+    {
+        return "missing field while loading grades data from text file";
+    }
+    if (parse_uint(p, fields[0], id) != fields[0])
+    {
+        return "invalid student id while loading grades data from text file";
+    }
+    // the name is resolved directly from the mapped bytes
+    const char *name_begin = fields[0] + 1;
+    *course_index = course_lookup_find(lookup, name_begin, fields[1] - name_begin);
+    if (*course_index < 0)
+    {
+        return "course not found in courses table";
+    }
+    const char *cursor = fields[1] + 1;
+    if (!parse_grade(&cursor, fields[2], grade))
+    {
+        return "invalid grade while loading grades data from text file";
+    }
+    return NULL;
+}
+
+/// @brief Parse a grade line "id;nom;note". Exit if the line is invalid.
+/// @param p first byte of the line
+/// @param end end of the readable buffer
+/// @param eol receives the end of the line
+/// @param id receives the student id
+/// @param lookup the courses name lookup table
+/// @param course_index receives the index of the course in the courses table
+/// @return the parsed (and validated) grade
+static grade_t parse_grade_line(const char *p, const char *end, const char **eol, unsigned int *id,
+                                const Course_lookup *lookup, int *course_index)
+{
+    grade_t grade = 0;
+    const char *error = read_grade_line(p, end, eol, id, lookup, course_index, &grade);
+    verify(!error, error);
+    return grade;
+}
+
+void mmap_load_grades_data(Promotion *prom, Section_span span)
+{
+    assert(prom && span.begin && span.begin <= span.end);
+    assert(prom->course_lookup && prom->stu_index);
+    promotion_grades_changed(prom);
+    // grades are pushed once all are parsed, in tables allocated at their exact size
+    GradeEntries *entries = GradeEntries_init();
+    const char *p = span.begin;
+    while (p < span.end && isdigit((unsigned char)*p))
+    {
+        // data format is id;nom;note
+        const char *eol = NULL;
+        Grade_entry entry;
+        unsigned int id = 0; // student id
+        entry.grade = parse_grade_line(p, span.end, &eol, &id, prom->course_lookup,
+                                       &entry.course_index);
+        entry.stu = student_index_find(prom->stu_index, id);
+        verify(entry.stu, "unknown student id while loading grades data from text file");
+        GradeEntries_push(entry, entries);
+        p = eol < span.end ? eol + 1 : span.end;
+    }
+    add_grade_entries(&entries, 1, prom->arena);
+    GradeEntries_free(entries, NULL);
+    // updating grades avg :
+    evaluate_all_student_average(prom);
+}
+
+/// @brief A chunk of the grades section parsed by one thread. Parsed grades are dispatched in one
+/// table per student partition so that each partition can later be applied by a single thread.
+typedef struct grades_chunk
+{
+    const char *begin;            //!< First byte of the chunk (start of a line)
+    const char *end;              //!< One past the last byte of the chunk
+    Student_index *stu_index;     //!< Students id index (read only while parsing)
+    Course_lookup *course_lookup; //!< Courses name lookup table (read only while parsing)
+    GradeEntries **parts;         //!< One table of parsed grades per partition
+    int n_parts;                  //!< Number of partitions (number of threads)
+    ///@brief First line not parsed (not a grade line, or an invalid one), NULL if the whole chunk
+    /// is parsed
+    const char *stop;
+} Grades_chunk;
+
+/// @brief Set of students (id % n_parts == part_index) whose grades are applied by one thread
+typedef struct grades_partition
+{
+    Grades_chunk *chunks; //!< All the parsed chunks, in file order
+    int n_chunks;         //!< Number of chunks to apply
+    int part_index;       //!< Index of the partition to apply
+    Arena *arena;         //!< Arena of the thread, NULL if the students are allocated with malloc
+} Grades_partition;
+
+/// @brief Thread entry : parse a chunk of the grades section (no shared data is modified). The
+/// chunk stops at its first line that isn't a valid grade line : it may be after the end of the
+/// grades lines, which is only known once every chunk is parsed.
+static void *parse_grades_chunk(void *arg)
+{
+    Grades_chunk *chunk = arg;
+    // ids are spread evenly over the partitions : reserve a fair share of the lines (plus slack)
+    int n_lines = count_lines(chunk->begin, chunk->end);
+    int share = n_lines / chunk->n_parts;
+    for (int i = 0; i < chunk->n_parts; i++)
+    {
+        GradeEntries_reserve(chunk->parts[i], share + share / 8 + 1);
+    }
+    const char *p = chunk->begin;
+    while (p < chunk->end)
+    {
+        const char *eol = NULL;
+        Grade_entry entry;
+        unsigned int id = 0;
+        // same stop condition as the serial loader
+        bool is_valid = isdigit((unsigned char)*p) &&
+                        !read_grade_line(p, chunk->end, &eol, &id, chunk->course_lookup,
+                                         &entry.course_index, &entry.grade);
+        entry.stu = is_valid ? student_index_find(chunk->stu_index, id) : NULL;
+        if (!entry.stu)
+        {
+            chunk->stop = p;
+            break;
+        }
+        GradeEntries_push(entry, chunk->parts[id % chunk->n_parts]);
+        p = eol < chunk->end ? eol + 1 : chunk->end;
+    }
+    return NULL;
+}
+
+/// @brief Thread entry : push the grades of one partition, chunk after chunk (file order is kept)
+static void *apply_grades_partition(void *arg)
+{
+    Grades_partition *part = arg;
+    GradeEntries *tables[MAX_LOAD_THREADS];
+    for (int c = 0; c < part->n_chunks; c++)
+    {
+        tables[c] = part->chunks[c].parts[part->part_index];
+    }
+    add_grade_entries(tables, part->n_chunks, part->arena);
+    return NULL;
+}
+
+void mmap_load_grades_data_parallel(Promotion *prom, Section_span span, int n_threads)
+{
+    assert(prom && span.begin && span.begin <= span.end);
+    n_threads = get_n_threads(n_threads);
+    if (n_threads > MAX_LOAD_THREADS)
+    {
+        n_threads = MAX_LOAD_THREADS;
+    }
+    size_t len = span.end - span.begin;
+    if (n_threads == 1 || len < PARALLEL_GRADES_MIN_BYTES)
+    {
+        mmap_load_grades_data(prom, span); // not worth the threads
+        return;
+    }
+
+    promotion_grades_changed(prom);
+    // split the section in n_threads chunks on line boundaries
+    Grades_chunk chunks[MAX_LOAD_THREADS];
+    const char *chunk_begin = span.begin;
+    for (int i = 0; i < n_threads; i++)
+    {
+        const char *chunk_end = span.end;
+        if (i < n_threads - 1)
+        {
+            chunk_end = span.begin + len * (i + 1) / n_threads;
+            if (chunk_end < chunk_begin)
+            {
+                chunk_end = chunk_begin;
+            }
+            chunk_end = find_eol(chunk_end, span.end);
+            chunk_end = chunk_end < span.end ? chunk_end + 1 : span.end;
+        }
+        chunks[i] = (Grades_chunk){.begin = chunk_begin,
+                                   .end = chunk_end,
+                                   .stu_index = prom->stu_index,
+                                   .course_lookup = prom->course_lookup,
+                                   .n_parts = n_threads,
+                                   .stop = NULL};
+        chunks[i].parts = malloc(n_threads * sizeof(GradeEntries *));
+        verify(chunks[i].parts, "malloc error");
+        for (int j = 0; j < n_threads; j++)
+        {
+            chunks[i].parts[j] = GradeEntries_init();
+        }
+        chunk_begin = chunk_end;
+    }
+    run_threads(parse_grades_chunk, chunks, sizeof(Grades_chunk), n_threads);
+
+    // the grades lines end in the first chunk that stopped early : ignore the chunks after it
+    int n_chunks = 0;
+    while (n_chunks < n_threads && !chunks[n_chunks].stop)
+    {
+        n_chunks++;
+    }
+    if (n_chunks < n_threads)
+    {
+        const char *stop = chunks[n_chunks].stop;
+        if (isdigit((unsigned char)*stop)) // an invalid grade line : exit as the serial loader
+        {
+            const char *eol = NULL;
+            unsigned int id = 0;
+            int course_index = -1;
+            parse_grade_line(stop, chunks[n_chunks].end, &eol, &id, prom->course_lookup,
+                             &course_index);
+            verify(student_index_find(prom->stu_index, id),
+                   "unknown student id while loading grades data from text file");
+        }
+        n_chunks++;
+    }
+
+    Grades_partition parts[MAX_LOAD_THREADS];
+    for (int i = 0; i < n_threads; i++)
+    {
+        parts[i] = (Grades_partition){.chunks = chunks, .n_chunks = n_chunks, .part_index = i};
+        // an arena isn't thread safe : each thread grows its Grades in its own one
+        parts[i].arena = prom->arena ? init_arena(len / n_threads) : NULL;
+    }
+    run_threads(apply_grades_partition, parts, sizeof(Grades_partition), n_threads);
+
+    for (int i = 0; i < n_threads; i++)
+    {
+        if (parts[i].arena)
+        {
+            arena_adopt(prom->arena, parts[i].arena);
+            free_arena(parts[i].arena);
+        }
+        for (int j = 0; j < n_threads; j++)
+        {
+            GradeEntries_free(chunks[i].parts[j], NULL);
+        }
+        free(chunks[i].parts);
+    }
+    // updating grades avg :
+    evaluate_all_student_average(prom);
+}
+
+int mmap_apply_grades_data(Promotion *prom, Section_span span)
+{
+    assert(prom && prom->course_lookup && prom->stu_index);
+    Promotion_columns *cols = get_promotion_columns(prom);
+    promotion_changed(prom); // averages change : sorted permutations are out of date
+    int n_grades = 0;
+    const char *p = span.begin;
+    while (p < span.end && isdigit((unsigned char)*p))
+    {
+        // data format is id;nom;note
+        const char *eol = NULL;
+        unsigned int id = 0; // student id
+        int course_index = -1;
+        grade_t grade =
+                parse_grade_line(p, span.end, &eol, &id, prom->course_lookup, &course_index);
+        Student *stu = student_index_find(prom->stu_index, id);
+        verify(stu, "unknown student id while applying grades from text file");
+        apply_grade_to_student(stu, prom->courses, course_index, grade, prom->arena);
+        promotion_columns_update_student(cols, stu, course_index);
+        n_grades++;
+        p = eol < span.end ? eol + 1 : span.end;
+    }
+    return n_grades;
+}
+
+int mmap_apply_grades(Promotion *prom, const char *file_path)
+{
+    assert(prom && file_path);
+    Mapped_file mfile = map_data_file(file_path);
+    const Section sections[] = {SECTION_CONTENT};
+    const Section grades_section = sections[sizeof(sections) / sizeof(sections[0]) - 1];
+    Section_span span = {.begin = mfile.data, .end = mfile.data + mfile.len};
+    if (mfile.len > 0 && !isdigit((unsigned char)*span.begin))
+    {
+        const char *eol = find_eol(span.begin, span.end);
+        if (line_equals(span.begin, eol, grades_section.section_header))
+        {
+            span.begin = eol < span.end ? eol + 1 : span.end; // skip the header line
+        }
+        else
+        {
+            // full data file (or section title first) : only keep the grades section
+            locate_sections(&mfile, &grades_section, 1, &span);
+        }
+    }
+    int n_grades = mmap_apply_grades_data(prom, span);
+    unmap_data_file(&mfile);
+    return n_grades;
+}
+
+Promotion *mmap_load_promotion(const char *file_path)
+{
+    assert(file_path);
+    Mapped_file mfile = map_data_file(file_path);
+    const Section sections[] = {SECTION_CONTENT};
+    const int n_sections = sizeof(sections) / sizeof(sections[0]);
+    assert(n_sections == 3);
+    Section_span spans[sizeof(sections) / sizeof(sections[0])];
+    locate_sections(&mfile, sections, n_sections, spans);
+
+    // the text size is a fair estimation of the memory needed (one block for small files)
+    Arena *arena = init_arena(mfile.len);
+    String_pool *names = init_string_pool(arena, 0);
+    StudentsTab *stu_dtab = mmap_load_student_tab_data(spans[0], arena, names);
+    CoursesTab *courses = mmap_load_courses_data(spans[1]);
+    // allocate the proper grades dynamic tables (size supposed const for simplicity)
+    allocate_students_courses(stu_dtab, courses->size, arena);
+    Promotion *prom = init_promotion(courses, stu_dtab, arena, names);
+    mmap_load_grades_data_parallel(prom, spans[2], LOAD_N_THREADS);
+    unmap_data_file(&mfile);
+    return prom;
+}
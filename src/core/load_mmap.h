@@ -0,0 +1,113 @@
+#ifndef LOAD_MMAP_H
+#define LOAD_MMAP_H
+
+/// @file load_mmap.h
+/// @brief Functions to load data from text files mapped in memory (no stdio buffering).
+/// The file is mapped read-only and fields are parsed directly from the mapped pages.
+/// @see load_data.h (both loaders must build the exact same promotion)
+
+#include "load_data.h"
+
+#ifndef LOAD_N_THREADS
+/// @brief Number of threads used to load the grades section, 0 to use every online CPU
+#define LOAD_N_THREADS 0
+#endif
+
+#ifndef MAX_LOAD_THREADS
+/// @brief Maximum number of threads used to load the grades section
+#define MAX_LOAD_THREADS 64
+#endif
+
+#ifndef PARALLEL_GRADES_MIN_BYTES
+/// @brief Grades sections smaller than this (in bytes) are always loaded by a single thread
+#define PARALLEL_GRADES_MIN_BYTES (1024 * 1024)
+#endif
+
+/// @brief Read-only memory mapping of a whole text file
+typedef struct mapped_file
+{
+    const char *data; //!< First byte of the mapping (NOT null terminated)
+    size_t len;       //!< Length of the file in bytes
+} Mapped_file;
+
+/// @brief Byte range of a section content, i.e. the lines following the section header
+typedef struct sect_span
+{
+    const char *begin; //!< First byte of the first line after the section header
+    const char *end;   //!< One past the last byte of the section content
+} Section_span;
+
+/// @brief Map a whole file in memory (read only). Exit on error.
+/// @param file_path the path to the file
+/// @return the mapping, to be released with unmap_data_file
+Mapped_file map_data_file(const char *file_path);
+
+/// @brief Release a mapping created by map_data_file
+/// @param mfile the mapping to release
+void unmap_data_file(Mapped_file *mfile);
+
+/// @brief Find the content of every section in one pass over the mapped file.
+/// Sections are expected in the given order, each one being a title line followed (possibly after
+/// other lines) by its header line. A section content ends where the next section title starts.
+/// Exit if a section title or header is missing.
+/// @param mfile the mapped file
+/// @param sections the sections to find, in file order
+/// @param n_sections the number of sections
+/// @param spans output table (of n_sections elements) receiving the content of each section
+void locate_sections(const Mapped_file *mfile, const Section sections[], int n_sections,
+                     Section_span spans[]);
+
+/// @brief Load the students data from a mapped section content
+/// @param span the content of the students section
+/// @param arena the arena to allocate the students in, NULL to use malloc
+/// @param names the pool to intern the names in (allocated in arena), NULL to copy them
+/// @return the loaded StudentsTab, sorted by id
+StudentsTab *mmap_load_student_tab_data(Section_span span, Arena *arena, String_pool *names);
+
+/// @brief Load the courses data from a mapped section content
+/// @param span the content of the courses section
+/// @return the loaded CoursesTab, sorted alphabetically
+CoursesTab *mmap_load_courses_data(Section_span span);
+
+/// @brief Load the grades data from a mapped section content and update the students' followed
+/// courses (and their averages). Grades are parsed first, then pushed in tables allocated at their
+/// exact size (see add_grade_entries) : the students must have no grade yet.
+/// @param prom the promotion struct containing students and courses tables
+/// @param span the content of the grades section
+void mmap_load_grades_data(Promotion *prom, Section_span span);
+
+/// @brief Same as mmap_load_grades_data, but the section is split on line boundaries into chunks
+/// parsed by n_threads threads. Each chunk stops at its first line that isn't a grade line, the
+/// chunks after the first one that stopped are ignored : the same lines as with the serial loader
+/// are loaded, and the same files are rejected. Parsed grades are then pushed by n_threads threads, each one owning
+/// a partition of the students and walking the chunks in file order : every Grades table receives
+/// its grades in the exact same order as with the serial loader. Each thread first counts the grades
+/// of each followed course and allocates its table once at its exact size (see add_grade_entries),
+/// in its own arena (merged into the promotion arena at the end). The students must have no grade yet.
+/// @param prom the promotion struct containing students and courses tables
+/// @param span the content of the grades section
+/// @param n_threads number of threads (at most MAX_LOAD_THREADS), 0 to use every online CPU
+void mmap_load_grades_data_parallel(Promotion *prom, Section_span span, int n_threads);
+
+/// @brief Apply the grades of a mapped grades section to an already loaded promotion. Averages and
+/// validation bitmasks are updated in O(1) per grade (see apply_grade_to_student).
+/// @param prom the loaded promotion (averages already evaluated)
+/// @param span the grades lines (format id;nom;note)
+/// @return the number of applied grades
+int mmap_apply_grades_data(Promotion *prom, Section_span span);
+
+/// @brief Apply a grades file to an already loaded promotion. The file is either a full data file
+/// (only its grades section is read) or a list of grade lines (id;nom;note), with or without the
+/// grades section header.
+/// @param prom the loaded promotion (averages already evaluated)
+/// @param file_path the path to the grades file
+/// @return the number of applied grades
+int mmap_apply_grades(Promotion *prom, const char *file_path);
+
+/// @brief Load a whole promotion from a text file using a memory mapping. The students and
+/// everything they own are allocated in an arena owned by the promotion.
+/// @param file_path the path to the data file
+/// @return the loaded promotion
+Promotion *mmap_load_promotion(const char *file_path);
+
+#endif
@@ -37,7 +37,7 @@ void bin_save_student(Student *stu, FILE *file)
            "couldn't save student age (int) while saving to binary");
     for (int i = 0; i < stu->n_courses; i++)
     {
-        bin_save_followed_course(stu->f_courses[i], file);
+        bin_save_followed_course(&stu->f_courses[i], file);
     }
 }
 
@@ -46,5 +46,5 @@ void bin_save_followed_course(Followed_course *fcourse, FILE *file)
     assert(file && followed_course_is_valid(fcourse));
     verify(fwrite(&(fcourse->average), sizeof(float), 1, file) == 1,
            "couldn't save followed course average (float) while saving followed course to binary");
-    Grades_save_to_bin(fcourse->grades, file, NULL);
+    Grades_save_to_bin(&fcourse->grades, file, NULL);
 }
\ No newline at end of file
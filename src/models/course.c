@@ -63,6 +63,56 @@ int get_course_index_in_table(CoursesTab *courses, char *searched_name)
     return -1;
 }
 
+Course_lookup *init_course_lookup(CoursesTab *courses)
+{
+    assert(CoursesTab_is_valid(courses, course_is_valid));
+    Course_lookup *lookup = (Course_lookup *)malloc(sizeof(Course_lookup));
+    verify(lookup, "malloc error");
+    lookup->courses = courses;
+    // at most half full so that probing sequences stay short (and there is always an empty slot)
+    lookup->n_slots = 1;
+    while (lookup->n_slots < 2 * courses->size + 1)
+    {
+        lookup->n_slots *= 2;
+    }
+    lookup->slots = (int *)malloc(lookup->n_slots * sizeof(int));
+    lookup->hashes = (unsigned int *)malloc(lookup->n_slots * sizeof(unsigned int));
+    lookup->name_lens = (size_t *)malloc(lookup->n_slots * sizeof(size_t));
+    verify(lookup->slots && lookup->hashes && lookup->name_lens, "malloc error");
+    for (int i = 0; i < lookup->n_slots; i++)
+    {
+        lookup->slots[i] = -1;
+    }
+    int mask = lookup->n_slots - 1;
+    for (int c = 0; c < courses->size; c++)
+    {
+        char *name = courses->tab[c]->name;
+        size_t len = strlen(name);
+        unsigned int hash = hash_course_name(name, len);
+        int i = hash & mask;
+        while (lookup->slots[i] > -1)
+        {
+            i = (i + 1) & mask;
+        }
+        lookup->slots[i] = c;
+        lookup->hashes[i] = hash;
+        lookup->name_lens[i] = len;
+    }
+    return lookup;
+}
+
+void free_course_lookup(Course_lookup *lookup)
+{
+    assert(lookup);
+    free(lookup->slots);
+    free(lookup->hashes);
+    free(lookup->name_lens);
+    lookup->slots = NULL;
+    lookup->hashes = NULL;
+    lookup->name_lens = NULL;
+    free(lookup);
+}
+
 void print_course(Course *course)
 {
     if (course == NULL)
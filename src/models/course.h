@@ -5,6 +5,7 @@
 /// @brief Structure and functions to handle courses data
 
 #include "../other/dyn_table.h"
+#include "../other/utils.h"
 
 #ifndef COEF_MIN
 /// @brief Minimum valid coefficient value
@@ -28,6 +29,24 @@ typedef struct course
 
 DECLARE_DYN_TABLE(Course *, CoursesTab)
 
+/// @brief Open addressing hash table (linear probing) mapping a course name to its index in a
+/// CoursesTab. Built once the courses table is complete, it resolves a name with one hash and
+/// (almost always) a single memcmp instead of a strcmp binary search.
+/// **Must be rebuilt if the courses table is modified.**
+typedef struct course_lookup
+{
+    ///@brief index in the courses table of the course stored in each slot, -1 if the slot is empty
+    int *slots;
+    ///@brief hash of the name of the course stored in each slot
+    unsigned int *hashes;
+    ///@brief length of the name of the course stored in each slot (compared before the name)
+    size_t *name_lens;
+    ///@brief number of slots (power of two)
+    int n_slots;
+    ///@brief the indexed courses table (not owned)
+    CoursesTab *courses;
+} Course_lookup;
+
 /// @brief allocate and initialise a course
 /// @param coef coef of the course
 /// @param course_name name of the course
@@ -50,6 +69,51 @@ int compare_courses(const void *c1, const void *c2);
 /// @return the index of the Course in the courses table
 int get_course_index_in_table(CoursesTab *tab, char *searched_name);
 
+/// @brief Build the name lookup table of a courses table
+/// @param courses the courses table to index (must not be modified while the lookup is used)
+/// @return the allocated lookup table
+Course_lookup *init_course_lookup(CoursesTab *courses);
+
+/// @brief Free a course lookup table (the indexed courses table is not freed)
+/// @param lookup the lookup table to free
+void free_course_lookup(Course_lookup *lookup);
+
+/// @brief Hash a course name (FNV-1a, see hash_string)
+/// @param name the name (does not need to be null terminated)
+/// @param len the length of the name
+/// @return the hash of the name
+static inline unsigned int hash_course_name(const char *name, size_t len)
+{
+    return hash_string(name, len);
+}
+
+/// @brief Get a course index given its name, using a lookup table
+/// @param lookup the lookup table
+/// @param name the searched name (does not need to be null terminated)
+/// @param len the length of the searched name
+/// @return the index of the Course in the courses table, -1 if not found
+static inline int course_lookup_find(const Course_lookup *lookup, const char *name, size_t len)
+{
+    assert(lookup && name);
+    unsigned int hash = hash_course_name(name, len);
+    int mask = lookup->n_slots - 1;
+    for (int i = hash & mask;; i = (i + 1) & mask)
+    {
+        int index = lookup->slots[i];
+        if (index < 0)
+        {
+            return -1; // empty slot : not found
+        }
+        const char *slot_name = lookup->courses->tab[index]->name;
+        // same length first : memcmp must not read past the end of a shorter name
+        if (lookup->hashes[i] == hash && lookup->name_lens[i] == len &&
+            memcmp(slot_name, name, len) == 0)
+        {
+            return index;
+        }
+    }
+}
+
 /// @brief print a course
 /// @param course course to print
 void print_course(Course *course);
@@ -0,0 +1,85 @@
+#include <assert.h>
+#include <string.h>
+
+#include "course_stats.h"
+#include "../other/utils.h"
+
+void compute_course_stats(const Promotion_columns *cols, Course_stats *stats)
+{
+    assert(cols && (stats || cols->n_courses == 0));
+    int n_courses = cols->n_courses;
+    double *sums = (double *)calloc(n_courses > 0 ? n_courses : 1, sizeof(double));
+    double *squares = (double *)calloc(n_courses > 0 ? n_courses : 1, sizeof(double));
+    verify(sums && squares, "malloc error");
+    for (int j = 0; j < n_courses; j++)
+    {
+        stats[j] = (Course_stats){.count = 0, .n_validated = 0, .min = GRADE_MAX, .max = GRADE_MIN};
+        memset(stats[j].histogram, 0, sizeof(stats[j].histogram));
+    }
+    const double bins_per_point = COURSE_STATS_BINS / (GRADE_MAX - GRADE_MIN);
+
+    // one pass over the course averages matrix, in memory order
+    for (int row = 0; row < cols->n_rows; row++)
+    {
+        const float *course_avgs = cols->course_avgs + (long)row * n_courses;
+        __uint32_t mask = cols->masks[row];
+        for (int j = 0; j < n_courses; j++)
+        {
+            float avg = course_avgs[j];
+            if (avg <= GRADE_MIN) // no grades in this course
+            {
+                continue;
+            }
+            Course_stats *course = &stats[j];
+            course->count++;
+            course->n_validated += mask >> j & 1;
+            sums[j] += avg;
+            squares[j] += (double)avg * avg;
+            course->min = avg < course->min ? avg : course->min;
+            course->max = avg > course->max ? avg : course->max;
+            int bin = (int)((avg - GRADE_MIN) * bins_per_point);
+            course->histogram[bin < COURSE_STATS_BINS ? bin : COURSE_STATS_BINS - 1]++;
+        }
+    }
+
+    for (int j = 0; j < n_courses; j++)
+    {
+        Course_stats *course = &stats[j];
+        if (course->count == 0)
+        {
+            course->mean = course->min = course->max = -1;
+            course->variance = 0;
+            continue;
+        }
+        double mean = sums[j] / course->count;
+        double variance = squares[j] / course->count - mean * mean;
+        course->mean = (float)mean;
+        course->variance = variance > 0 ? (float)variance : 0; // rounding may make it negative
+    }
+    free(sums);
+    free(squares);
+}
+
+float course_stats_percentile(const Course_stats *stats, float percent)
+{
+    assert(stats && percent >= 0 && percent <= 100);
+    if (stats->count == 0)
+    {
+        return -1;
+    }
+    double rank = percent / 100.0 * stats->count; // number of averages below the percentile
+    const double bin_width = (GRADE_MAX - GRADE_MIN) / COURSE_STATS_BINS;
+    int below = 0;
+    for (int b = 0; b < COURSE_STATS_BINS; b++)
+    {
+        int in_bin = stats->histogram[b];
+        if (in_bin > 0 && below + in_bin >= rank)
+        {
+            // averages supposed evenly spread in their bin, the extrema are exact
+            float value = (float)(GRADE_MIN + (b + (rank - below) / in_bin) * bin_width);
+            return value < stats->min ? stats->min : value > stats->max ? stats->max : value;
+        }
+        below += in_bin;
+    }
+    return stats->max;
+}
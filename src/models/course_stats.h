@@ -0,0 +1,58 @@
+#ifndef COURSE_STATS_H
+#define COURSE_STATS_H
+
+/// @file course_stats.h
+/// @brief Distribution of the averages of the students in each course : count, mean, variance,
+/// extrema, validations and a histogram giving the median and any percentile. Every course is
+/// computed in a single pass over the course averages of the promotion columns.
+
+#include "promotion_columns.h"
+
+#ifndef COURSE_STATS_BINS
+/// @brief Number of bins of the histogram of a course, over [GRADE_MIN, GRADE_MAX] (400 : 0.05
+/// point each)
+#define COURSE_STATS_BINS 400
+#endif
+
+/// @brief Statistics of the averages of the students in a course. Students without grades in the
+/// course are not counted.
+typedef struct course_stats
+{
+    ///@brief number of students with an average in the course
+    int count;
+    ///@brief number of these students having validated the course
+    int n_validated;
+    ///@brief mean of the averages (-1 if count is 0)
+    float mean;
+    ///@brief variance of the averages (population variance, 0 if count is 0)
+    float variance;
+    ///@brief lowest average (-1 if count is 0)
+    float min;
+    ///@brief highest average (-1 if count is 0)
+    float max;
+    ///@brief number of averages in each bin of (GRADE_MAX - GRADE_MIN) / COURSE_STATS_BINS points
+    int histogram[COURSE_STATS_BINS];
+} Course_stats;
+
+/// @brief Compute the statistics of every course of columns, in a single pass over their course
+/// averages (sums in double precision)
+/// @param cols the columns (their averages and bitmasks, the grades may be stale)
+/// @param stats receives the statistics of each course (cols->n_courses elements allocated)
+void compute_course_stats(const Promotion_columns *cols, Course_stats *stats);
+
+/// @brief Get a percentile of the averages of a course from its histogram (interpolated in its
+/// bin, so within a bin width of the exact value)
+/// @param stats the statistics of the course
+/// @param percent the percentile, between 0 and 100 (50 for the median)
+/// @return the average below which percent % of the averages are, -1 if count is 0
+float course_stats_percentile(const Course_stats *stats, float percent);
+
+/// @brief Get the share of the students of a course having validated it
+/// @param stats the statistics of the course
+/// @return n_validated / count, 0 if count is 0
+static inline float course_stats_pass_rate(const Course_stats *stats)
+{
+    return stats->count > 0 ? (float)stats->n_validated / stats->count : 0;
+}
+
+#endif
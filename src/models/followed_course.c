@@ -1,38 +1,83 @@
 #include <assert.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 
 #include "../other/utils.h"
 #include "followed_course.h"
 
-DEFINE_DYN_TABLE(float, Grades)
+DEFINE_DYN_TABLE_VIEW(grade_t, Grades)
 
-Followed_course *init_followed_course(Grades *(*init_grades)())
+Followed_course *init_followed_course(Arena *arena)
 {
-    Followed_course *f_course = malloc(sizeof(Followed_course));
+    Followed_course *f_course = arena ? arena_alloc(arena, sizeof(Followed_course))
+                                      : malloc(sizeof(Followed_course));
     verify(f_course, "malloc error");
+    init_followed_course_in_place(f_course);
+    return f_course;
+}
+
+void init_followed_course_in_place(Followed_course *f_course)
+{
+    assert(f_course);
     f_course->average = -1;
-    if (init_grades != NULL)
+    f_course->grades_sum = 0;
+    f_course->grades.tab = f_course->inline_grades;
+    f_course->grades.capacity = GRADES_INLINE_SIZE;
+    f_course->grades.size = 0;
+}
+
+void followed_course_reserve(Followed_course *fcourse, int capacity, Arena *arena)
+{
+    assert(fcourse);
+    Grades *grades = &fcourse->grades;
+    if (capacity <= grades->capacity)
     {
-        f_course->grades = Grades_init();
-        assert(Grades_is_valid(f_course->grades, grade_is_valid));
+        return;
     }
-    return f_course;
+    size_t old_size = grades->capacity * sizeof(grade_t);
+    size_t new_size = capacity * sizeof(grade_t);
+    grade_t *tab = NULL;
+    if (grades->tab == fcourse->inline_grades) // leaving the inline storage
+    {
+        tab = arena ? arena_alloc(arena, new_size) : malloc(new_size);
+        verify(tab, "malloc error");
+        memcpy(tab, grades->tab, grades->size * sizeof(grade_t));
+    }
+    else if (arena)
+    {
+        tab = arena_realloc(arena, grades->tab, old_size, new_size);
+    }
+    else
+    {
+        tab = realloc(grades->tab, new_size);
+        verify(tab, "realloc error");
+    }
+    grades->tab = tab;
+    grades->capacity = capacity;
 }
 
 void free_followed_course(Followed_course *f_course)
 {
-    assert(followed_course_is_valid(f_course));
-    Grades_free(f_course->grades, NULL);
-    f_course->grades = NULL;
+    clear_followed_course(f_course);
     free(f_course);
 }
 
+void clear_followed_course(Followed_course *f_course)
+{
+    assert(followed_course_is_valid(f_course));
+    if (f_course->grades.tab != f_course->inline_grades)
+    {
+        free(f_course->grades.tab);
+    }
+    init_followed_course_in_place(f_course);
+}
+
 void print_fcourse(Followed_course *fcourse)
 {
     assert(followed_course_is_valid(fcourse));
     printf("Average : %.2f\n", fcourse->average);
-    Grades_print(fcourse->grades, print_float);
+    Grades_print(&fcourse->grades, print_grade);
 }
 
 bool followed_course_is_valid(Followed_course *fcourse)
@@ -49,7 +94,7 @@ bool followed_course_is_valid(Followed_course *fcourse)
         fprintf(stderr, BOLD_RED "^ Invalid followed course average\n" RESET);
         return false;
     }
-    return Grades_is_valid(fcourse->grades, grade_is_valid);
+    return Grades_is_valid(&fcourse->grades, stored_grade_is_valid);
 }
 
 bool grade_is_valid(float val)
@@ -4,9 +4,45 @@
 /// @file followed_course.h
 /// @brief Structure and functions to handle followed courses data
 
+#include <stdint.h>
+
+#include "../other/arena.h"
 #include "../other/dyn_table.h"
+#include "../other/utils.h"
+
+/// @brief Define to store grades in fixed point (integer tenths of point, see GRADE_SCALE) instead
+/// of floats. Grades are then parsed exactly, take 2 bytes instead of 4, and course averages are
+/// accumulated in integers (exact and reproducible).
+/// Binary files saved in one mode can't be restored in the other one.
+// #define FIXED_POINT_GRADES
+
+#ifdef FIXED_POINT_GRADES
+/// @brief Type of a stored grade : tenths of point
+typedef uint16_t grade_t;
+/// @brief Type of a sum of stored grades
+typedef uint64_t grade_sum_t;
+
+/// @brief Number of stored grade units per point
+#define GRADE_SCALE 10
+/// @brief Minimum valid grade (in tenths of point)
+#define GRADE_FIXED_MIN (0 * GRADE_SCALE)
+/// @brief Maximum valid grade (in tenths of point)
+#define GRADE_FIXED_MAX (20 * GRADE_SCALE)
+/// @brief Minimum average (in tenths of point) to validate a course
+#define GRADE_FIXED_TO_VALIDATE (10 * GRADE_SCALE)
 
-DECLARE_DYN_TABLE(float, Grades)
+// bounds in points, used for averages (derived from the fixed point bounds)
+/// @brief Minimum valid grade value
+#define GRADE_MIN (GRADE_FIXED_MIN / (double)GRADE_SCALE - 0.0001)
+/// @brief Maximum valid grade value
+#define GRADE_MAX (GRADE_FIXED_MAX / (double)GRADE_SCALE + 0.0001)
+/// @brief Grade value used to represent unvalidated courses
+#define GRADE_TO_VALIDATE (GRADE_FIXED_TO_VALIDATE / (double)GRADE_SCALE - 0.0001)
+#else
+/// @brief Type of a stored grade : points
+typedef float grade_t;
+/// @brief Type of a sum of stored grades
+typedef float grade_sum_t;
 
 #ifndef GRADE_MIN
 /// @brief Minimum valid grade value
@@ -19,6 +55,18 @@ DECLARE_DYN_TABLE(float, Grades)
 
 /// @brief Grade value used to represent unvalidated courses
 #define GRADE_TO_VALIDATE 9.9999
+#endif
+
+/// @brief Grades table of a followed course. Its storage is inline or in the promotion arena : it is
+/// declared as a view (no _push, _reserve nor _free), see followed_course_add_grade and
+/// followed_course_reserve
+DECLARE_DYN_TABLE_VIEW(grade_t, Grades)
+
+#ifndef GRADES_INLINE_SIZE
+/// @brief Number of grades stored inline in a followed course (at least 1) : the grades table of a
+/// followed course only gets its own allocation beyond this number of grades
+#define GRADES_INLINE_SIZE 4
+#endif
 
 /// @brief Enum listing all possible courses
 /// does not correspond to course id in the CoursesTable, just a convenient way to refer to courses.
@@ -63,38 +111,156 @@ typedef enum _cindex
 #define YEAR_MASK (SCIENCES_MASK | HUMANITIES_MASK)
 
 /// @brief The courses followed by a specific student.
+/// The grades table is small-buffer optimised : its first GRADES_INLINE_SIZE grades are stored in
+/// inline_grades (grades.tab then points to it), so most followed courses need no allocation. A
+/// followed course must therefore not be copied or moved once initialised.
 typedef struct followed_course
 {
-    ///@brief dynamic table of grades
-    Grades *grades;
+    ///@brief dynamic table of grades, only grows through followed_course_add_grade and
+    /// followed_course_reserve
+    Grades grades;
+    ///@brief running sum of the grades (in insertion order), kept up to date by
+    /// followed_course_add_grade so that the average can be updated in O(1)
+    grade_sum_t grades_sum;
     ///@brief average of the followed course
     float average;
+    ///@brief inline storage of the grades table while it holds at most GRADES_INLINE_SIZE grades
+    grade_t inline_grades[GRADES_INLINE_SIZE];
 } Followed_course;
 
-/// @brief Create a followed course, it's average is initialised to -1 and
-/// the Grades are allocated using the init_grades function. If init_grades NULL, this step will be
-/// skipped.
-/// @param init_grades The function used to allocate
+/// @brief Create a followed course, its average is initialised to -1 and its grades table is
+/// empty (stored inline)
+/// @param arena the arena to allocate the followed course in, NULL to use malloc (the followed
+/// course is then freed with free_followed_course)
 /// @return The created followed course
-Followed_course *init_followed_course(Grades *(*init_grades)());
+Followed_course *init_followed_course(Arena *arena);
+
+/// @brief Initialise a followed course stored in place (in the f_courses table of a student), same
+/// as init_followed_course without allocating the followed course itself
+/// @param f_course the followed course to initialise
+void init_followed_course_in_place(Followed_course *f_course);
+
+/// @brief Make room for at least capacity grades in the grades table of a followed course
+/// (exactly capacity if it has to grow)
+/// @param fcourse the followed course
+/// @param capacity the wished capacity
+/// @param arena the arena owning the followed course, NULL if it was allocated with malloc
+void followed_course_reserve(Followed_course *fcourse, int capacity, Arena *arena);
 
 /// @brief Free a followed course
 /// @param f_course the followed course to free
 void free_followed_course(Followed_course *f_course);
 
+/// @brief Free the grades table of a followed course stored in place (allocated with malloc), the
+/// followed course itself is not freed
+/// @param f_course the followed course to clear
+void clear_followed_course(Followed_course *f_course);
+
+/// @brief Convert a stored grade to points
+/// @param grade the stored grade
+/// @return the grade in points
+static inline float grade_to_float(grade_t grade)
+{
+#ifdef FIXED_POINT_GRADES
+    return grade / (float)GRADE_SCALE;
+#else
+    return grade;
+#endif
+}
+
+/// @brief Get an average (in points) from a sum of stored grades
+/// @param total the sum of the grades
+/// @param n_elem the number of grades
+/// @return the average, -1 if no grades
+static inline float grade_sum_to_avg(grade_sum_t total, int n_elem)
+{
+    if (n_elem <= 0)
+    {
+        return -1;
+    }
+#ifdef FIXED_POINT_GRADES
+    return (float)((double)total / ((double)GRADE_SCALE * n_elem));
+#else
+    return total / n_elem;
+#endif
+}
+
+/// @brief Sum stored grades, in table order (the order matters for float grades)
+/// @param grades the grades
+/// @param n_elem the number of grades
+/// @return the sum of the grades
+static inline grade_sum_t sum_grades(const grade_t *grades, int n_elem)
+{
+    grade_sum_t total = 0;
+    for (int i = 0; i < n_elem; i++)
+    {
+        total += grades[i];
+    }
+    return total;
+}
+
 /// @brief Get the average of a followed course given its grades
 /// @param fcourse the followed course
 /// @return the average of the followed course, -1 if no grades
 static inline float get_followed_course_avg(Followed_course *fcourse)
 {
     assert(fcourse);
-    float total = 0;
-    int n_elem = fcourse->grades->size;
-    for (int i = 0; i < n_elem; i++)
+    int n_elem = fcourse->grades.size;
+    return grade_sum_to_avg(sum_grades(fcourse->grades.tab, n_elem), n_elem);
+}
+
+/// @brief Add a grade to a followed course and update its running sum (the average is not updated)
+/// @param fcourse the followed course
+/// @param grade the grade to add
+/// @param arena the arena owning the followed course, NULL if it was allocated with malloc
+static inline void followed_course_add_grade(Followed_course *fcourse, grade_t grade,
+                                             Arena *arena)
+{
+    assert(fcourse);
+    Grades *grades = &fcourse->grades;
+    if (grades->size >= grades->capacity)
     {
-        total += fcourse->grades->tab[i];
+        followed_course_reserve(fcourse, DYN_TABLE_GROWTH(grades->capacity), arena);
     }
-    return n_elem > 0 ? total / n_elem : -1;
+    grades->tab[grades->size++] = grade;
+    fcourse->grades_sum += grade;
+}
+
+/// @brief Get the average of a followed course from its running sum, in O(1).
+/// Gives the same result as get_followed_course_avg (the sum is accumulated in the same order).
+/// @param fcourse the followed course
+/// @return the average of the followed course, -1 if no grades
+static inline float get_followed_course_running_avg(Followed_course *fcourse)
+{
+    assert(fcourse);
+    return grade_sum_to_avg(fcourse->grades_sum, fcourse->grades.size);
+}
+
+/// @brief Check if a set of grades validates a course (average at least GRADE_TO_VALIDATE). In
+/// fixed point mode, the check is done exactly on the grades sum.
+/// @param total the sum of the grades
+/// @param n_elem the number of grades
+/// @param avg the average of the grades (see grade_sum_to_avg)
+/// @return true if validated
+static inline bool grades_are_validated(grade_sum_t total, int n_elem, float avg)
+{
+#ifdef FIXED_POINT_GRADES
+    (void)avg;
+    return n_elem > 0 && total >= GRADE_FIXED_TO_VALIDATE * (grade_sum_t)n_elem;
+#else
+    (void)total;
+    (void)n_elem;
+    return avg >= GRADE_TO_VALIDATE;
+#endif
+}
+
+/// @brief Check if a followed course is validated (average at least GRADE_TO_VALIDATE). The
+/// average must be up to date. See grades_are_validated.
+/// @param fcourse the followed course
+/// @return true if validated
+static inline bool followed_course_is_validated(Followed_course *fcourse)
+{
+    return grades_are_validated(fcourse->grades_sum, fcourse->grades.size, fcourse->average);
 }
 
 /// @brief Print a followed course
@@ -106,9 +272,39 @@ void print_fcourse(Followed_course *fcourse);
 /// @return true if valid, false otherwise
 bool followed_course_is_valid(Followed_course *fcourse);
 
-/// @brief Check if a grade is valid
+/// @brief Check if a grade (or an average) in points is valid
 /// @param val the grade value to check
 /// @return true if valid, false otherwise
 bool grade_is_valid(float val);
 
+/// @brief Check if a stored grade is valid
+/// @param grade the stored grade to check
+/// @return true if valid, false otherwise
+static inline bool stored_grade_is_valid(grade_t grade)
+{
+#ifdef FIXED_POINT_GRADES
+#if GRADE_FIXED_MIN > 0 // grade_t is unsigned : the lower bound only matters if positive
+    bool too_low = grade < GRADE_FIXED_MIN;
+#else
+    bool too_low = false;
+#endif
+    if (too_low || grade > GRADE_FIXED_MAX)
+    {
+        fprintf(stderr,
+                BOLD_RED "ERROR : stored grade %u is invalid (GRADE_FIXED_MIN = %d, "
+                         "GRADE_FIXED_MAX = %d)\n" RESET,
+                (unsigned int)grade, GRADE_FIXED_MIN, GRADE_FIXED_MAX);
+        return false;
+    }
+    return true;
+#else
+    return grade_is_valid(grade);
+#endif
+}
+
+/// @brief Print a stored grade (in points)
+/// Used as a callback for Grades_print
+/// @param grade the grade to print
+static inline void print_grade(grade_t grade) { print_float(grade_to_float(grade)); }
+
 #endif
\ No newline at end of file
@@ -1,17 +1,32 @@
-#include <float.h>
-
+#include "../other/top_k.h"
 #include "../other/utils.h"
 #include "promotion.h"
 
 DEFINE_DYN_TABLE(Student *, StudentsTab)
 
-Promotion *init_promotion(CoursesTab *ctab, StudentsTab *stu_dtab)
+Promotion *init_promotion(CoursesTab *ctab, StudentsTab *stu_dtab, Arena *arena,
+                          String_pool *names)
 {
+    assert(!names || (arena && names->arena == arena));
+    // checked for every loader : validation bitmasks (and bitmaps) have one bit per course
+    verify(!ctab || ctab->size <= MAX_FOLLOWED_COURSES,
+           "too many courses (a promotion has at most MAX_FOLLOWED_COURSES courses)");
     Promotion *prom = (Promotion *)malloc(sizeof(Promotion));
     verify(prom, "malloc error");
     prom->courses = ctab;
+    prom->course_lookup = ctab ? init_course_lookup(ctab) : NULL;
     prom->stu_dtab = stu_dtab;
+    prom->stu_index = stu_dtab ? init_student_index(stu_dtab) : NULL;
+    prom->arena = arena;
+    prom->names = names;
+    prom->columns = NULL;
     prom->compare_student = compare_student_id;
+    prom->generation = 0;
+    for (int i = 0; i < N_SORT_MODES + 1; i++)
+    {
+        prom->sort_caches[i] =
+                (Sort_cache){.students = NULL, .size = 0, .n_sorted = 0, .generation = 0};
+    }
     return prom;
 }
 
@@ -35,69 +50,157 @@ int compare_student_fname(const void *a, const void *b)
 {
     const Student *s1 = *(const Student **)a;
     const Student *s2 = *(const Student **)b;
-    return strcmp(s1->fname, s2->fname);
+    // interned first names are equal if and only if they are the same string
+    return s1->fname == s2->fname ? 0 : strcmp(s1->fname, s2->fname);
 }
 
 int compare_student_name(const void *a, const void *b)
 {
     const Student *s1 = *(const Student **)a;
     const Student *s2 = *(const Student **)b;
-    return strcmp(s1->name, s2->name);
+    return s1->name == s2->name ? 0 : strcmp(s1->name, s2->name);
 }
 
 int compare_student_average(const void *a, const void *b)
 {
     const Student *s1 = *(const Student **)a;
     const Student *s2 = *(const Student **)b;
-    return s1->average - s2->average;
+    return (s1->average > s2->average) - (s1->average < s2->average);
 }
 
 int compare_student_minimum(const void *a, const void *b)
 {
     const Student *s1 = *(const Student **)a;
     const Student *s2 = *(const Student **)b;
-    float min_s1 = GRADE_MAX;
-    float min_s2 = GRADE_MAX;
-    for (int i = 0; i < s1->n_courses; i++)
+    float min_s1 = s1->min_course_avg;
+    float min_s2 = s2->min_course_avg;
+    return (min_s1 < min_s2) - (min_s1 > min_s2);
+}
+
+Student *student_tab_bsearch(StudentsTab *stu_dtab, unsigned int searched_id)
+{
+    assert(StudentsTab_is_valid(stu_dtab, student_is_valid));
+    Student tmp = {.id = searched_id}; // dummy student
+    Student **res = (Student **)bsearch(&tmp, stu_dtab->tab, stu_dtab->size, sizeof(Student *),
+                                        compare_student_to_key);
+    return res ? *res : NULL;
+}
+
+/// @brief Allocate n_slots (power of two) empty slots in a student index
+static void student_index_alloc_slots(Student_index *index, int n_slots)
+{
+    index->n_slots = n_slots;
+    index->slots = (Student **)calloc(n_slots, sizeof(Student *));
+    verify(index->slots, "calloc error");
+}
+
+Student_index *init_student_index(StudentsTab *stu_dtab)
+{
+    assert(StudentsTab_is_valid(stu_dtab, student_is_valid));
+    Student_index *index = (Student_index *)malloc(sizeof(Student_index));
+    verify(index, "malloc error");
+    int n_slots = 1;
+    while (n_slots < 2 * stu_dtab->size + 1)
+    {
+        n_slots *= 2;
+    }
+    student_index_alloc_slots(index, n_slots);
+    index->size = 0;
+    for (int i = 0; i < stu_dtab->size; i++)
     {
-        if (s1->f_courses[i]->average < min_s1)
+        verify(student_index_insert(index, stu_dtab->tab[i]),
+               "duplicated student id while building the students index");
+    }
+    return index;
+}
+
+void free_student_index(Student_index *index)
+{
+    assert(index);
+    free(index->slots);
+    index->slots = NULL;
+    free(index);
+}
+
+bool student_index_insert(Student_index *index, Student *stu)
+{
+    assert(index && stu);
+    if (2 * (index->size + 1) > index->n_slots) // keep the load factor under 1/2
+    {
+        Student **old_slots = index->slots;
+        int old_n_slots = index->n_slots;
+        student_index_alloc_slots(index, old_n_slots * 2);
+        index->size = 0;
+        for (int i = 0; i < old_n_slots; i++)
         {
-            min_s1 = s1->f_courses[i]->average;
+            if (old_slots[i])
+            {
+                student_index_insert(index, old_slots[i]);
+            }
         }
+        free(old_slots);
     }
-    for (int i = 0; i < s2->n_courses; i++)
+    int mask = index->n_slots - 1;
+    int i = hash_student_id(stu->id) & mask;
+    while (index->slots[i])
     {
-        if (s2->f_courses[i]->average < min_s2)
+        if (index->slots[i]->id == stu->id)
         {
-            min_s2 = s2->f_courses[i]->average;
+            return false;
         }
+        i = (i + 1) & mask;
     }
-    return (min_s1 < min_s2) - (min_s1 > min_s2);
+    index->slots[i] = stu;
+    index->size++;
+    return true;
 }
 
-Student *student_tab_bsearch(StudentsTab *stu_dtab, unsigned int searched_id)
+bool promotion_add_student(Promotion *prom, Student *stu)
 {
-    assert(StudentsTab_is_valid(stu_dtab, student_is_valid));
-    Student tmp = {.id = searched_id}; // dummy student
-    Student **res = (Student **)bsearch(&tmp, stu_dtab->tab, stu_dtab->size, sizeof(Student *),
-                                        compare_student_to_key);
-    return res ? *res : NULL;
+    assert(prom && prom->stu_dtab && prom->stu_index && student_is_valid(stu));
+    if (!student_index_insert(prom->stu_index, stu))
+    {
+        return false;
+    }
+    StudentsTab_push(stu, prom->stu_dtab);
+    promotion_changed(prom);
+    if (prom->columns) // rebuilt on next use
+    {
+        free_promotion_columns(prom->columns);
+        prom->columns = NULL;
+    }
+    return true;
+}
+
+Promotion_columns *get_promotion_columns(Promotion *prom)
+{
+    assert(prom && prom->stu_dtab && prom->courses);
+    if (!prom->columns)
+    {
+        prom->columns = init_promotion_columns(prom->stu_dtab->tab, prom->stu_dtab->size,
+                                               prom->courses);
+    }
+    assert(prom->columns->n_rows == prom->stu_dtab->size);
+    return prom->columns;
 }
 
-void allocate_students_courses(StudentsTab *stu_dtab, int n_courses)
+void allocate_students_courses(StudentsTab *stu_dtab, int n_courses, Arena *arena)
 {
     assert(StudentsTab_is_valid(stu_dtab, student_is_valid) && n_courses > 0);
     for (int i = 0; i < stu_dtab->size; i++)
     {
         Student *stu = stu_dtab->tab[i];
         stu->n_courses = n_courses;
-        stu->f_courses = (Followed_course **)malloc(n_courses * sizeof(Followed_course *));
-        assert(stu->f_courses);
+        // one block per student, the followed courses are stored inline
+        size_t f_courses_size = n_courses * sizeof(Followed_course);
+        stu->f_courses = (Followed_course *)(arena ? arena_alloc(arena, f_courses_size)
+                                                   : malloc(f_courses_size));
+        verify(stu->f_courses, "malloc error");
         for (int j = 0; j < n_courses; j++)
         {
-            stu->f_courses[j] = init_followed_course(Grades_init);
-            assert(stu->f_courses[j]);
+            init_followed_course_in_place(&stu->f_courses[j]);
         }
+        reset_student_min_course_avg(stu);
     }
 }
 
@@ -113,6 +216,31 @@ void free_promotion(Promotion *prom, void (*free_student_f)(Student *),
                     void (*free_course_f)(Course *))
 {
     assert(prom); // don't check its content
+    if (prom->course_lookup) // always owned by the promotion
+    {
+        free_course_lookup(prom->course_lookup);
+        prom->course_lookup = NULL;
+    }
+    if (prom->stu_index) // always owned by the promotion
+    {
+        free_student_index(prom->stu_index);
+        prom->stu_index = NULL;
+    }
+    if (prom->columns) // always owned by the promotion
+    {
+        free_promotion_columns(prom->columns);
+        prom->columns = NULL;
+    }
+    for (int i = 0; i < N_SORT_MODES + 1; i++)
+    {
+        free(prom->sort_caches[i].students);
+        prom->sort_caches[i].students = NULL;
+    }
+    if (prom->names) // the pool only indexes the names, they are released with the arena
+    {
+        free_string_pool(prom->names);
+        prom->names = NULL;
+    }
     // If free_course_f or free_student_f is NULL, that mean we don't want to free them
     if (free_course_f)
     {
@@ -122,8 +250,14 @@ void free_promotion(Promotion *prom, void (*free_student_f)(Student *),
     if (free_student_f)
     {
         assert(StudentsTab_is_valid(prom->stu_dtab, student_is_valid));
-        StudentsTab_free(prom->stu_dtab, free_student_f);
+        // students in an arena are all released with it
+        StudentsTab_free(prom->stu_dtab, prom->arena ? NULL : free_student_f);
+        if (prom->arena)
+        {
+            free_arena(prom->arena);
+        }
     }
+    prom->arena = NULL;
     prom->courses = NULL;
     prom->stu_dtab = NULL;
     free(prom);
@@ -162,106 +296,418 @@ bool students_id_are_sorted_and_unique(StudentsTab *stu_dtab)
     return true;
 }
 
-StudentsTab *get_top_students(StudentsTab *stu_dtab, int top_max_size)
+#ifndef RADIX_SORT_MIN_SIZE
+/// @brief Numeric sorting modes use a radix sort from this number of students (a comparison sort
+/// below, both give the same order)
+#define RADIX_SORT_MIN_SIZE 256
+#endif
+
+#ifndef PARTIAL_SORT_MAX_SHARE
+/// @brief Only the first students are sorted (partial sort) when at most 1 / PARTIAL_SORT_MAX_SHARE
+/// of them are wanted, the whole promotion is sorted otherwise
+#define PARTIAL_SORT_MAX_SHARE 8
+#endif
+
+/// @brief A sort key and the row of its student
+typedef struct row_key
 {
-    assert(StudentsTab_is_valid(stu_dtab, student_is_valid) && top_max_size > 0);
+    union
+    {
+        unsigned int num; //!< Numeric modes : id, or order preserving key of a float
+        const char *str;  //!< Name modes : the interned name
+    } key;   //!< The key (type depending on the sorting mode)
+    int row; //!< Row of the student in the promotion columns, breaks ties
+} Row_key;
+
+/// @brief Order of the numeric keys (growing)
+#define ROW_NUM_LESS(a, b)                                                                         \
+    ((a).key.num < (b).key.num || ((a).key.num == (b).key.num && (a).row < (b).row))
+
+/// @brief Order of the name keys (alphabetical)
+static inline bool row_str_less(Row_key a, Row_key b)
+{
+    int cmp = a.key.str == b.key.str ? 0 : strcmp(a.key.str, b.key.str);
+    return cmp < 0 || (cmp == 0 && a.row < b.row);
+}
+
+DEFINE_INLINE_SORT(Row_key, sort_row_keys_by_num, ROW_NUM_LESS)
+DEFINE_INLINE_SORT(Row_key, sort_row_keys_by_str, row_str_less)
 
-    StudentsTab *top = StudentsTab_init();
-    if (stu_dtab->size == 0)
+/// @brief Check if row keys are already in growing numeric order (keys are created in row order,
+/// so ties are in order too)
+static bool row_keys_are_sorted(const Row_key *keys, int n)
+{
+    for (int i = 1; i < n; i++)
     {
-        return top;
+        if (keys[i].key.num < keys[i - 1].key.num)
+        {
+            return false;
+        }
     }
-    float worst_in_top = -FLT_MAX; // worst average of the student in the top 10
-    for (int i = 0; i < stu_dtab->size; i++)
+    return true;
+}
+
+/// @brief Sort row keys by growing numeric key with a LSD radix sort (8 bits per pass). The sort
+/// is stable, like ROW_NUM_LESS. Passes where every key has the same digit are skipped.
+/// @param keys the keys to sort
+/// @param n the number of keys
+static void radix_sort_row_keys(Row_key *keys, int n)
+{
+    enum
     {
-        Student *stu = stu_dtab->tab[i];
-        if (top->size < top_max_size)
+        RADIX_BITS = 8,
+        RADIX_SIZE = 1 << RADIX_BITS,
+        N_PASSES = 32 / RADIX_BITS
+    };
+    // histograms of every pass in a single read of the keys
+    int counts[N_PASSES][RADIX_SIZE] = {{0}};
+    for (int i = 0; i < n; i++)
+    {
+        unsigned int num = keys[i].key.num;
+        for (int pass = 0; pass < N_PASSES; pass++)
         {
-            // Augment table size by one
-            StudentsTab_push(stu, top);
+            counts[pass][(num >> (pass * RADIX_BITS)) & (RADIX_SIZE - 1)]++;
         }
-        else if (stu->average <= worst_in_top)
+    }
+    Row_key *tmp = (Row_key *)malloc(n * sizeof(Row_key));
+    verify(tmp, "malloc error");
+    Row_key *src = keys;
+    Row_key *dst = tmp;
+    for (int pass = 0; pass < N_PASSES; pass++)
+    {
+        int shift = pass * RADIX_BITS;
+        int *count = counts[pass];
+        if (count[(src[0].key.num >> shift) & (RADIX_SIZE - 1)] == n)
+        {
+            continue; // same digit everywhere : nothing to do
+        }
+        int offset = 0; // counts become the first position of each digit
+        for (int d = 0; d < RADIX_SIZE; d++)
         {
-            continue;
+            int n_digit = count[d];
+            count[d] = offset;
+            offset += n_digit;
         }
-        // shift every student whose position is inferior to stu
-        int j = top->size - 2;
-        while (j > -1 && stu->average > top->tab[j]->average)
+        for (int i = 0; i < n; i++)
         {
-            top->tab[j + 1] = top->tab[j];
-            j--;
+            dst[count[(src[i].key.num >> shift) & (RADIX_SIZE - 1)]++] = src[i];
         }
-        top->tab[j + 1] = stu;
-        worst_in_top = top->tab[top->size - 1]->average;
+        Row_key *swap = src;
+        src = dst;
+        dst = swap;
+    }
+    if (src != keys)
+    {
+        memcpy(keys, src, n * sizeof(Row_key));
     }
+    free(tmp);
+}
 
-    return top;
+/// @brief Get the index of the sort cache of a compare function
+/// @return the index, N_SORT_MODES if the compare function isn't one of compare_student_*
+static int sort_cache_index(int (*compare)(const void *, const void *))
+{
+    int (*const modes[N_SORT_MODES])(const void *, const void *) = {
+            compare_student_id, compare_student_fname, compare_student_name,
+            compare_student_average, compare_student_minimum};
+    int i = 0;
+    while (i < N_SORT_MODES && modes[i] != compare)
+    {
+        i++;
+    }
+    return i;
+}
+
+/// @brief Sort the rows of the promotion columns with one of the compare_student_* functions.
+/// Sort keys are read from the columns once per student instead of at each comparison.
+/// @param cols the columns
+/// @param compare the compare function
+/// @param k number of students wanted in order, the whole promotion is sorted if k is too big (see
+/// PARTIAL_SORT_MAX_SHARE)
+/// @param sorted receives every student, the first ones in sorted order (cols->n_rows elements)
+/// @return the number of students in sorted order at the start of sorted (at least k)
+static int sort_rows(Promotion_columns *cols, int (*compare)(const void *, const void *), int k,
+                     Student **sorted)
+{
+    int n = cols->n_rows;
+    bool by_name = compare == compare_student_fname || compare == compare_student_name;
+    Row_key *keys = (Row_key *)malloc((n + 1) * sizeof(Row_key));
+    verify(keys, "malloc error");
+    for (int row = 0; row < n; row++)
+    {
+        keys[row].row = row;
+        if (compare == compare_student_id)
+        {
+            keys[row].key.num = cols->ids[row];
+        }
+        else if (compare == compare_student_fname)
+        {
+            keys[row].key.str = cols->students[row]->fname;
+        }
+        else if (compare == compare_student_name)
+        {
+            keys[row].key.str = cols->students[row]->name;
+        }
+        else if (compare == compare_student_average)
+        {
+            keys[row].key.num = float_to_ordered_key(cols->averages[row]);
+        }
+        else // decreasing minimum : complement of the growing key
+        {
+            keys[row].key.num = ~float_to_ordered_key(cols->min_avgs[row]);
+        }
+    }
+    int n_sorted = n;
+    if (k <= n / PARTIAL_SORT_MAX_SHARE) // select the k first keys, only sort them
+    {
+        n_sorted = k;
+        if (by_name)
+        {
+            sort_row_keys_by_str_partial(keys, n, k);
+        }
+        else
+        {
+            sort_row_keys_by_num_partial(keys, n, k);
+        }
+    }
+    else if (by_name)
+    {
+        sort_row_keys_by_str(keys, n);
+    }
+    else if (row_keys_are_sorted(keys, n))
+    {
+        // nothing to do (e.g. the table is usually already sorted by id)
+    }
+    else if (n < RADIX_SORT_MIN_SIZE)
+    {
+        sort_row_keys_by_num(keys, n);
+    }
+    else
+    {
+        radix_sort_row_keys(keys, n);
+    }
+    for (int i = 0; i < n; i++)
+    {
+        sorted[i] = cols->students[keys[i].row];
+    }
+    free(keys);
+    return n_sorted;
+}
+
+Student **get_sorted_students(Promotion *prom)
+{
+    assert(prom && prom->stu_dtab);
+    return get_first_sorted_students(prom, prom->stu_dtab->size);
+}
+
+Student **get_first_sorted_students(Promotion *prom, int k)
+{
+    assert(promotion_is_valid(prom) && k > -1);
+    StudentsTab *stu_dtab = prom->stu_dtab;
+    k = k < stu_dtab->size ? k : stu_dtab->size;
+    int (*compare)(const void *, const void *) = prom->compare_student;
+    int index = sort_cache_index(compare);
+    Sort_cache *cache = &prom->sort_caches[index];
+    if (index < N_SORT_MODES && cache->students && cache->generation == prom->generation &&
+        cache->n_sorted >= k)
+    {
+        assert(cache->size == stu_dtab->size);
+        return cache->students; // up to date
+    }
+    if (!cache->students || cache->size != stu_dtab->size)
+    {
+        free(cache->students);
+        cache->students = (Student **)malloc((stu_dtab->size + 1) * sizeof(Student *));
+        verify(cache->students, "malloc error");
+        cache->size = stu_dtab->size;
+    }
+    cache->generation = prom->generation;
+    if (index == N_SORT_MODES) // unknown compare function : sort a copy of the table
+    {
+        memcpy(cache->students, stu_dtab->tab, stu_dtab->size * sizeof(Student *));
+        qsort(cache->students, stu_dtab->size, sizeof(Student *), compare);
+        cache->n_sorted = stu_dtab->size;
+        return cache->students;
+    }
+    Promotion_columns *cols = get_promotion_columns(prom);
+    assert(cols->n_rows == stu_dtab->size);
+    cache->n_sorted = sort_rows(cols, compare, k, cache->students);
+    return cache->students;
+}
+
+/// @brief Make a students table of the entries of a top k heap (best first), and free the heap
+/// @param top the heap, rows of cols
+/// @param cols the columns
+/// @return the students table
+static StudentsTab *top_k_to_students(Top_k *top, const Promotion_columns *cols)
+{
+    int n = top_k_sort(top);
+    StudentsTab *stu_dtab = StudentsTab_init();
+    StudentsTab_reserve(stu_dtab, n);
+    for (int i = 0; i < n; i++)
+    {
+        StudentsTab_push(cols->students[top->heap[i].row], stu_dtab);
+    }
+    free_top_k(top);
+    return stu_dtab;
+}
+
+StudentsTab *get_top_students(Promotion *prom, int top_max_size)
+{
+    assert(promotion_is_valid(prom) && top_max_size > -1);
+    Promotion_columns *cols = get_promotion_columns(prom);
+    Top_k *top = init_top_k(top_max_size < cols->n_rows ? top_max_size : cols->n_rows);
+    for (int row = 0; row < cols->n_rows; row++)
+    {
+        top_k_push(top, float_to_ordered_key(cols->averages[row]), row);
+    }
+    return top_k_to_students(top, cols);
+}
+
+StudentsTab *get_bottom_students(Promotion *prom, int bottom_max_size)
+{
+    assert(promotion_is_valid(prom) && bottom_max_size > -1);
+    Promotion_columns *cols = get_promotion_columns(prom);
+    Top_k *bottom = init_top_k(bottom_max_size < cols->n_rows ? bottom_max_size : cols->n_rows);
+    for (int row = 0; row < cols->n_rows; row++)
+    {
+        // complement of the key : the smallest averages are kept
+        top_k_push(bottom, ~float_to_ordered_key(cols->averages[row]), row);
+    }
+    return top_k_to_students(bottom, cols);
 }
 
 StudentsTab *get_top_students_in_course(Promotion *prom, char *course_name, int top_max_size)
 {
-    assert(promotion_is_valid(prom) && course_name && top_max_size > 0);
+    assert(promotion_is_valid(prom) && course_name && top_max_size > -1);
 
-    int course_id = get_course_index_in_table(prom->courses, course_name);
+    int course_id = course_lookup_find(prom->course_lookup, course_name, strlen(course_name));
     if (course_id < 0)
     {
         return NULL;
-        // exit(EXIT_FAILURE);
     }
 
-    StudentsTab *top = StudentsTab_init();
-    StudentsTab *dtab = prom->stu_dtab;
-    if (dtab->size == 0)
+    Promotion_columns *cols = get_promotion_columns(prom);
+    Top_k *top = init_top_k(top_max_size < cols->n_rows ? top_max_size : cols->n_rows);
+    // column course_id of the course averages matrix
+    const float *course_avgs = cols->course_avgs + course_id;
+    const int stride = cols->n_courses;
+    for (int row = 0; row < cols->n_rows; row++)
     {
-        return top;
+        top_k_push(top, float_to_ordered_key(course_avgs[(long)row * stride]), row);
     }
+    return top_k_to_students(top, cols);
+}
 
-    float worst_in_top = -FLT_MAX;
-
-    for (int i = 0; i < dtab->size; i++)
+StudentsTab **get_top_students_all_courses(Promotion *prom, int top_max_size)
+{
+    assert(promotion_is_valid(prom) && top_max_size > -1);
+    Promotion_columns *cols = get_promotion_columns(prom);
+    int n_courses = cols->n_courses;
+    int k = top_max_size < cols->n_rows ? top_max_size : cols->n_rows;
+    Top_k **tops = (Top_k **)malloc((n_courses > 0 ? n_courses : 1) * sizeof(Top_k *));
+    verify(tops, "malloc error");
+    for (int j = 0; j < n_courses; j++)
     {
-        Student *stu = dtab->tab[i];
-        float avg = stu->f_courses[course_id]->average;
-
-        if (top->size < top_max_size)
-        {
-            StudentsTab_push(stu, top);
-        }
-        else if (avg <= worst_in_top)
+        tops[j] = init_top_k(k);
+    }
+    // one pass over the course averages matrix, in memory order
+    for (int row = 0; row < cols->n_rows; row++)
+    {
+        const float *course_avgs = cols->course_avgs + (long)row * n_courses;
+        for (int j = 0; j < n_courses; j++)
         {
-            continue;
+            top_k_push(tops[j], float_to_ordered_key(course_avgs[j]), row);
         }
+    }
+    StudentsTab **tabs = (StudentsTab **)malloc((n_courses > 0 ? n_courses : 1) *
+                                                sizeof(StudentsTab *));
+    verify(tabs, "malloc error");
+    for (int j = 0; j < n_courses; j++)
+    {
+        tabs[j] = top_k_to_students(tops[j], cols);
+    }
+    free(tops);
+    return tabs;
+}
 
-        int j = top->size - 2;
-        while (j > -1 && avg > top->tab[j]->f_courses[course_id]->average)
-        {
-            top->tab[j + 1] = top->tab[j];
-            j--;
-        }
-        top->tab[j + 1] = stu;
-        worst_in_top = top->tab[top_max_size - 1]->f_courses[course_id]->average;
+int count_students_validated(Promotion *prom, __uint32_t courses_bitmask)
+{
+    assert(promotion_is_valid(prom));
+    return promotion_columns_count_validated(get_promotion_columns(prom), courses_bitmask);
+}
+
+StudentsTab *get_students_validated(Promotion *prom, __uint32_t courses_bitmask)
+{
+    assert(promotion_is_valid(prom));
+    Promotion_columns *cols = get_promotion_columns(prom);
+    int *rows = (int *)malloc((cols->n_rows > 0 ? cols->n_rows : 1) * sizeof(int));
+    verify(rows, "malloc error");
+    int n = promotion_columns_get_validated(cols, courses_bitmask, rows);
+    StudentsTab *stu_dtab = StudentsTab_init();
+    StudentsTab_reserve(stu_dtab, n);
+    for (int i = 0; i < n; i++)
+    {
+        StudentsTab_push(cols->students[rows[i]], stu_dtab);
     }
-    return top;
+    free(rows);
+    return stu_dtab;
+}
+
+Validation_summary get_validation_summary(Promotion *prom)
+{
+    assert(promotion_is_valid(prom));
+    Validation_summary summary;
+    summary.n_students = prom->stu_dtab->size;
+    summary.sciences = count_students_validated(prom, SCIENCES_MASK);
+    summary.humanities = count_students_validated(prom, HUMANITIES_MASK);
+    summary.year = count_students_validated(prom, YEAR_MASK);
+    summary.none = summary.n_students - summary.sciences - summary.humanities + summary.year;
+    return summary;
+}
+
+Course_stats *get_courses_stats(Promotion *prom)
+{
+    assert(promotion_is_valid(prom));
+    Promotion_columns *cols = get_promotion_columns(prom);
+    int n_courses = cols->n_courses;
+    Course_stats *stats = (Course_stats *)malloc((n_courses > 0 ? n_courses : 1) *
+                                                 sizeof(Course_stats));
+    verify(stats, "malloc error");
+    compute_course_stats(cols, stats);
+    return stats;
 }
 
 void evaluate_all_student_average(Promotion *prom)
 {
     assert(promotion_is_valid(prom));
-    CoursesTab *courses = prom->courses;
+    if (prom->columns && prom->columns->grades_are_stale)
+    {
+        free_promotion_columns(prom->columns);
+        prom->columns = NULL;
+    }
+    promotion_columns_evaluate_parallel(get_promotion_columns(prom), EVALUATE_N_THREADS);
+    promotion_changed(prom);
+#ifndef NDEBUG
     StudentsTab *stu_dtab = prom->stu_dtab;
     for (int i = 0; i < stu_dtab->size; i++)
     {
         Student *stu = stu_dtab->tab[i];
-        for (int j = 0; j < courses->size; j++)
+        for (int j = 0; j < prom->courses->size; j++)
         {
-            Followed_course *fcourse = stu->f_courses[j];
-            fcourse->average = get_followed_course_avg(fcourse);
-            assert(fcourse->average > GRADE_MIN && fcourse->average < GRADE_MAX);
+            // -1 if the course has no grade yet (grades may be added later, see API_apply_grades)
+            float avg = stu->f_courses[j].average;
+            assert(avg == -1 || (avg > GRADE_MIN && avg < GRADE_MAX));
         }
-        update_student_bitmask(stu);
-        stu->average = get_student_general_avg(stu, courses);
-        assert(stu->average > GRADE_MIN && stu->average < GRADE_MAX);
+        assert(stu->average == -1 || (stu->average > GRADE_MIN && stu->average < GRADE_MAX));
+        // the kernels of weighted_sums_in_range give the bits of the scalar loop
+        assert(stu->average == get_student_general_avg(stu, prom->courses));
+        float min_course_avg = stu->min_course_avg;
+        int weakest_course = stu->weakest_course;
+        reset_student_min_course_avg(stu);
+        assert(stu->min_course_avg == min_course_avg && stu->weakest_course == weakest_course);
     }
+#endif
 }
 
 char **get_students_names_and_fname(Student **tab, int n)
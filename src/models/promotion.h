@@ -1,6 +1,8 @@
 #ifndef PROMOTION_H
 #define PROMOTION_H
 
+#include "course_stats.h"
+#include "promotion_columns.h"
 #include "students.h"
 // #include "course.h"
 
@@ -9,15 +11,69 @@
 
 DECLARE_DYN_TABLE(Student *, StudentsTab)
 
+/// @brief Order of the students by id (same as compare_student_id), to use in DEFINE_INLINE_SORT
+#define STUDENT_ID_LESS(a, b) ((a)->id < (b)->id)
+
+// StudentsTab_sort_by_id : sort a students table by growing ids, comparisons inlined
+DEFINE_DYN_TABLE_SORT(Student *, StudentsTab, by_id, STUDENT_ID_LESS)
+
+/// @brief Open addressing hash table (linear probing) mapping a student id to the student.
+/// Students are stored by pointer, so the index stays valid when the students table is sorted.
+typedef struct student_index
+{
+    ///@brief student stored in each slot, NULL if the slot is empty
+    Student **slots;
+    ///@brief number of slots (power of two), always at least twice the number of students
+    int n_slots;
+    ///@brief number of indexed students
+    int size;
+} Student_index;
+
+/// @brief Number of sorting modes whose permutation is cached (one per compare_student_* function)
+#define N_SORT_MODES 5
+
+/// @brief A permutation of the students of a promotion, sorted with one compare function
+typedef struct sort_cache
+{
+    ///@brief the students in sorted order, NULL until first needed
+    Student **students;
+    ///@brief number of students in the permutation
+    int size;
+    ///@brief number of students in sorted order at the start of the permutation (size if it is
+    /// fully sorted, the others follow in any order)
+    int n_sorted;
+    ///@brief generation of the promotion the permutation was built at
+    unsigned long generation;
+} Sort_cache;
+
 /// @brief Structure representing a promotion containing students and courses dynamic tables.
 typedef struct promotion
 {
     ///@brief dynamic table of students
     StudentsTab *stu_dtab;
+    ///@brief id index of the students table, kept up to date by promotion_add_student
+    Student_index *stu_index;
     ///@brief dynamic table of courses
     CoursesTab *courses;
+    ///@brief name lookup table of the courses table (NULL if there is no courses table)
+    Course_lookup *course_lookup;
+    ///@brief arena owning the students and everything they own (names, followed courses, grades),
+    /// NULL if they are allocated with malloc
+    Arena *arena;
+    ///@brief pool the names and first names of the students are interned in (allocated in arena),
+    /// NULL if they aren't interned
+    String_pool *names;
+    ///@brief columnar copy of the students data, NULL until first needed (see
+    /// get_promotion_columns). Its order follows the students table.
+    Promotion_columns *columns;
     ///@brief compare function to sort students tab
     int (*compare_student)(const void *, const void *);
+    ///@brief number of modifications of the students (added students, grades, averages), see
+    /// promotion_changed. Sort caches built at an older generation are out of date.
+    unsigned long generation;
+    ///@brief sorted permutation of the students for each sorting mode, and a last one for any other
+    /// compare function (never reused), see get_sorted_students
+    Sort_cache sort_caches[N_SORT_MODES + 1];
 } Promotion;
 
 // Function prototypes
@@ -52,7 +108,8 @@ int compare_student_name(const void *a, const void *b);
 /// @return negative if a<b, 0 if a==b, positive if a>b
 int compare_student_average(const void *a, const void *b);
 
-/// @brief compare two students by their minimum grade among followed courses. To be used in qsort
+/// @brief compare two students by their minimum course average (Student.min_course_avg, not
+/// recomputed). To be used in qsort
 /// @param a pointer to first student
 /// @param b pointer to second student
 /// @return negative if a<b, 0 if a==b, positive if a>b
@@ -64,19 +121,108 @@ int compare_student_minimum(const void *a, const void *b);
 /// @return the found Student or NULL if not found
 Student *student_tab_bsearch(StudentsTab *prom, unsigned int searched_id);
 
+/// @brief Build the id index of a students table
+/// @param stu_dtab the students table to index
+/// @return the allocated index
+Student_index *init_student_index(StudentsTab *stu_dtab);
+
+/// @brief Free a student index (the indexed students are not freed)
+/// @param index the index to free
+void free_student_index(Student_index *index);
+
+/// @brief Add a student to an index, the index grows as needed
+/// @param index the index
+/// @param stu the student to add
+/// @return true if added, false if a student with the same id is already indexed
+bool student_index_insert(Student_index *index, Student *stu);
+
+/// @brief Hash a student id (murmur3 finalizer, spreads ids sharing their low bits)
+/// @param id the student id
+/// @return the hash of the id
+static inline unsigned int hash_student_id(unsigned int id)
+{
+    id ^= id >> 16;
+    id *= 0x85ebca6bu;
+    id ^= id >> 13;
+    id *= 0xc2b2ae35u;
+    id ^= id >> 16;
+    return id;
+}
+
+/// @brief Search for a student in an index by its ID (O(1) on average)
+/// @param index the index to search in
+/// @param searched_id the ID to search for
+/// @return the found Student or NULL if not found
+static inline Student *student_index_find(const Student_index *index, unsigned int searched_id)
+{
+    assert(index);
+    int mask = index->n_slots - 1;
+    for (int i = hash_student_id(searched_id) & mask;; i = (i + 1) & mask)
+    {
+        Student *stu = index->slots[i];
+        if (!stu || stu->id == searched_id)
+        {
+            return stu; // empty slot (not found) or found
+        }
+    }
+}
+
+/// @brief Add a student to a promotion (students table and id index)
+/// @param prom the promotion
+/// @param stu the student to add, owned by the promotion afterward
+/// @return true if added, false if a student with the same id already exists (stu is not added)
+bool promotion_add_student(Promotion *prom, Student *stu);
+
+/// @brief Get the columns of a promotion, built from its students on first use (or after students
+/// were added). Averages and bitmasks of the columns are those of the students, grades may be
+/// stale (see Promotion_columns.grades_are_stale).
+/// @param prom the promotion
+/// @return the columns, owned by the promotion
+Promotion_columns *get_promotion_columns(Promotion *prom);
+
+/// @brief Record a modification of the students of a promotion (added students, grades or
+/// averages) : the cached sorted permutations become out of date
+/// @param prom the promotion
+static inline void promotion_changed(Promotion *prom)
+{
+    assert(prom);
+    prom->generation++;
+}
+
+/// @brief Mark the grades of the promotion columns as stale. To call when grades are added to the
+/// students of a promotion without going through the columns.
+/// @param prom the promotion
+static inline void promotion_grades_changed(Promotion *prom)
+{
+    assert(prom);
+    promotion_changed(prom);
+    if (prom->columns)
+    {
+        prom->columns->grades_are_stale = true;
+    }
+}
+
 /// @brief Allocate the followed courses for each student in the StudentsTab
 /// @param prom the StudentsTab
 /// @param n_courses the number of courses to allocate for each student
-void allocate_students_courses(StudentsTab *prom, int n_courses);
+/// @param arena the arena owning the students, NULL if they are allocated with malloc
+void allocate_students_courses(StudentsTab *prom, int n_courses, Arena *arena);
 
 /// @brief Initialise a promotion given its courses and students tables.
 /// @param ctab Dynamic table of the courses. Can be NULL.
 /// @param stu_dtab Dynamic table of the students. Can be NULL.
+/// @param arena Arena the students are allocated in, owned by the promotion afterward. NULL if
+/// the students are allocated with malloc.
+/// @param names Pool the names of the students are interned in, owned by the promotion afterward.
+/// NULL if the names aren't interned.
 /// @return
-Promotion *init_promotion(CoursesTab *ctab, StudentsTab *stu_dtab);
+Promotion *init_promotion(CoursesTab *ctab, StudentsTab *stu_dtab, Arena *arena,
+                          String_pool *names);
 
 /// @brief Free a promotion and its contents using the provided free functions.
-/// If free_course_f or free_student_f is NULL, that mean we don't want to free the relevant data
+/// If free_course_f or free_student_f is NULL, that mean we don't want to free the relevant data.
+/// If the students are in an arena, free_student_f is not called : the whole arena is released at
+/// once (it is kept if free_student_f is NULL).
 /// @param prom the promotion to free
 /// @param free_student_f function to free a student
 /// @param free_course_f function to free a course
@@ -99,22 +245,100 @@ bool promotion_is_valid(Promotion *prom);
 /// @return true if sorted and unique, false otherwise
 bool students_id_are_sorted_and_unique(StudentsTab *stu_dtab);
 
-/// @brief Get the top students in a promotion based on their overall average
-/// @param stu_dtab the students table
+/// @brief Get the students of a promotion sorted with its compare_student function. The students
+/// table itself is not modified (it stays in id order). The permutation of each sorting mode is
+/// cached until the promotion changes (see promotion_changed), so switching between modes only
+/// sorts once per mode. Sort keys are read from the promotion columns, students with equal keys
+/// keep the order of the students table.
+/// @param prom the promotion
+/// @return the sorted students (prom->stu_dtab->size elements), owned by the promotion and valid
+/// until its next change or sort with an unknown compare function
+Student **get_sorted_students(Promotion *prom);
+
+/// @brief Get the k first students of a promotion with its compare_student function, like
+/// get_sorted_students. When few students are wanted, only they are sorted (partial sort, in
+/// O(n + k log k)) : the others follow in any order.
+/// @param prom the promotion
+/// @param k number of students wanted in sorted order (all of them if there are fewer students)
+/// @return every student (prom->stu_dtab->size elements), the k first ones in sorted order. Owned
+/// by the promotion, as for get_sorted_students.
+Student **get_first_sorted_students(Promotion *prom, int k);
+
+/// @brief Get the top students in a promotion based on their overall average (scan of the
+/// averages column with a bounded heap, O(n log k)). Students with equal averages are ranked by
+/// row.
+/// @param prom the promotion
 /// @param top_max_size the maximum number of top students to return
-/// @return a StudentsTab containing the top students
-StudentsTab *get_top_students(StudentsTab *stu_dtab, int top_max_size);
+/// @return a StudentsTab containing the top students, the best first
+StudentsTab *get_top_students(Promotion *prom, int top_max_size);
 
-/// @brief Get the top students in a specific course within a promotion
+/// @brief Get the students with the lowest overall average in a promotion (see get_top_students).
+/// Students without grades (average -1) come first.
+/// @param prom the promotion
+/// @param bottom_max_size the maximum number of students to return
+/// @return a StudentsTab containing the students, the lowest average first
+StudentsTab *get_bottom_students(Promotion *prom, int bottom_max_size);
+
+/// @brief Get the top students in a specific course within a promotion (see get_top_students)
 /// @param prom the promotion
 /// @param course_name the name of the course
 /// @param top_max_size the maximum number of top students to return
-/// @return a StudentsTab containing the top students in the specified course, NULL if course not
-/// found
+/// @return a StudentsTab containing the top students in the specified course, the best first.
+/// NULL if course not found
 StudentsTab *get_top_students_in_course(Promotion *prom, char *course_name, int top_max_size);
 
+/// @brief Get the top students of every course within a promotion, in a single pass over the
+/// students (one bounded heap per course, see get_top_students_in_course)
+/// @param prom the promotion
+/// @param top_max_size the maximum number of top students per course
+/// @return a table of prom->courses->size StudentsTab (one per course, in the order of the courses
+/// table) containing the top students in each course, the best first. The table and the
+/// StudentsTab must be freed (not the students).
+StudentsTab **get_top_students_all_courses(Promotion *prom, int top_max_size);
+
+/// @brief Count the students of a promotion having validated every course of a bitmask (see
+/// student_has_validated), on the validation bitmaps of the promotion columns
+/// @param prom the promotion
+/// @param courses_bitmask the courses (e.g. SCIENCES_MASK, 0 matches every student)
+/// @return the number of students
+int count_students_validated(Promotion *prom, __uint32_t courses_bitmask);
+
+/// @brief Get the students of a promotion having validated every course of a bitmask (see
+/// count_students_validated)
+/// @param prom the promotion
+/// @param courses_bitmask the courses
+/// @return a StudentsTab containing these students, in the order of the students table. It must
+/// be freed (not the students).
+StudentsTab *get_students_validated(Promotion *prom, __uint32_t courses_bitmask);
+
+/// @brief Number of students having validated the fields of a promotion (see
+/// print_student_validation)
+typedef struct validation_summary
+{
+    int n_students; //!< Number of students of the promotion
+    int sciences;   //!< Students having validated every science course (SCIENCES_MASK)
+    int humanities; //!< Students having validated every humanities course (HUMANITIES_MASK)
+    int year;       //!< Students having validated both fields (YEAR_MASK)
+    int none;       //!< Students having validated neither field
+} Validation_summary;
+
+/// @brief Count the students having validated each field of a promotion (see
+/// count_students_validated)
+/// @param prom the promotion
+/// @return the summary
+Validation_summary get_validation_summary(Promotion *prom);
+
+/// @brief Compute the statistics of the averages of every course of a promotion, in a single pass
+/// over the promotion columns (see compute_course_stats)
+/// @param prom the promotion
+/// @return a table of prom->courses->size statistics, in the order of the courses table. It must be
+/// freed.
+Course_stats *get_courses_stats(Promotion *prom);
+
 /// @brief Calculate and update the overall average for all students in the promotion
-/// and set validation bitmask to check if the student validate a followed course
+/// and set validation bitmask to check if the student validate a followed course.
+/// Evaluated over the promotion columns (rebuilt first if their grades are stale), by
+/// EVALUATE_N_THREADS threads on big promotions.
 /// @param prom the promotion
 void evaluate_all_student_average(Promotion *prom);
 
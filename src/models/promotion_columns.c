@@ -0,0 +1,335 @@
+#include <assert.h>
+#include <float.h>
+
+#include "promotion_columns.h"
+#include "../other/simd_avg.h"
+#include "../other/threads.h"
+#include "../other/utils.h"
+
+/// @brief Allocate a table of n elements of elem_size bytes, exit on error
+static void *alloc_column(long n, size_t elem_size)
+{
+    void *tab = malloc((n > 0 ? n : 1) * elem_size);
+    verify(tab, "malloc error");
+    return tab;
+}
+
+Promotion_columns *init_promotion_columns(Student **students, int n_students, CoursesTab *ctab)
+{
+    assert((students || n_students == 0) && n_students > -1 && ctab);
+    // the validation bitmaps are transposed through a stack array of MAX_FOLLOWED_COURSES words
+    verify(ctab->size <= MAX_FOLLOWED_COURSES, "too many courses for the promotion columns");
+    Promotion_columns *cols = (Promotion_columns *)malloc(sizeof(Promotion_columns));
+    verify(cols, "malloc error");
+    int n_courses = ctab->size;
+    long n_cells = (long)n_students * n_courses;
+    cols->n_rows = n_students;
+    cols->n_courses = n_courses;
+    cols->students = alloc_column(n_students, sizeof(Student *));
+    cols->ids = alloc_column(n_students, sizeof(unsigned int));
+    cols->ages = alloc_column(n_students, sizeof(int));
+    cols->averages = alloc_column(n_students, sizeof(float));
+    cols->masks = alloc_column(n_students, sizeof(__uint32_t));
+    cols->n_validation_words = (n_students + VALIDATION_WORD_BITS - 1) / VALIDATION_WORD_BITS;
+    cols->validated = alloc_column((long)n_courses * cols->n_validation_words, sizeof(__uint64_t));
+    cols->validated_is_stale = true;
+    cols->min_avgs = alloc_column(n_students, sizeof(float));
+    cols->course_avgs = alloc_column(n_cells, sizeof(float));
+    cols->coefs = alloc_column(n_courses, sizeof(float));
+    cols->grade_offsets = alloc_column(n_cells + 1, sizeof(long));
+    cols->grades_are_stale = false;
+    for (int j = 0; j < n_courses; j++)
+    {
+        cols->coefs[j] = ctab->tab[j]->coef;
+    }
+
+    // first pass : scalar columns and grades offsets
+    long n_grades = 0;
+    for (int i = 0; i < n_students; i++)
+    {
+        Student *stu = students[i];
+        assert(stu->n_courses == n_courses);
+        stu->row = i;
+        cols->students[i] = stu;
+        cols->ids[i] = stu->id;
+        cols->ages[i] = stu->age;
+        cols->averages[i] = stu->average;
+        cols->masks[i] = stu->course_validation_mask;
+        cols->min_avgs[i] = stu->min_course_avg;
+        for (int j = 0; j < n_courses; j++)
+        {
+            Followed_course *fcourse = &stu->f_courses[j];
+            cols->course_avgs[(long)i * n_courses + j] = fcourse->average;
+            cols->grade_offsets[(long)i * n_courses + j] = n_grades;
+            n_grades += fcourse->grades.size;
+        }
+    }
+    cols->grade_offsets[n_cells] = n_grades;
+
+    // second pass : copy the grades
+    cols->grades = alloc_column(n_grades, sizeof(grade_t));
+    grade_t *dst = cols->grades;
+    for (int i = 0; i < n_students; i++)
+    {
+        Followed_course *f_courses = students[i]->f_courses;
+        for (int j = 0; j < n_courses; j++)
+        {
+            const Grades *grades = &f_courses[j].grades;
+            memcpy(dst, grades->tab, grades->size * sizeof(grade_t));
+            dst += grades->size;
+        }
+    }
+    return cols;
+}
+
+void free_promotion_columns(Promotion_columns *cols)
+{
+    assert(cols);
+    for (int i = 0; i < cols->n_rows; i++)
+    {
+        cols->students[i]->row = -1;
+    }
+    free(cols->students);
+    free(cols->ids);
+    free(cols->ages);
+    free(cols->averages);
+    free(cols->masks);
+    free(cols->validated);
+    free(cols->min_avgs);
+    free(cols->course_avgs);
+    free(cols->coefs);
+    free(cols->grade_offsets);
+    free(cols->grades);
+    free(cols);
+}
+
+#ifndef EVALUATE_BLOCK_ROWS
+/// @brief Number of rows whose general averages are computed by a single call of
+/// weighted_sums_in_range (their course averages are still in cache)
+#define EVALUATE_BLOCK_ROWS 64
+#endif
+
+/// @brief Evaluate the rows [begin, end) of the columns (see promotion_columns_evaluate). Rows
+/// only write to their own cells and students : disjoint ranges can be evaluated concurrently.
+static void evaluate_rows(Promotion_columns *cols, int begin, int end)
+{
+    int n_courses = cols->n_courses;
+    for (int block = begin; block < end; block += EVALUATE_BLOCK_ROWS)
+    {
+        int block_end = block + EVALUATE_BLOCK_ROWS < end ? block + EVALUATE_BLOCK_ROWS : end;
+        for (int i = block; i < block_end; i++)
+        {
+            float *course_avgs = cols->course_avgs + (long)i * n_courses;
+            const long *offsets = cols->grade_offsets + (long)i * n_courses;
+            __uint32_t mask = 0;
+            float min_avg = FLT_MAX; // above any average : the first course is always taken
+            int weakest = -1;
+            for (int j = 0; j < n_courses; j++)
+            {
+                int n_elem = offsets[j + 1] - offsets[j];
+                grade_sum_t total = sum_grades(cols->grades + offsets[j], n_elem);
+                float avg = grade_sum_to_avg(total, n_elem);
+                course_avgs[j] = avg;
+                if (avg < min_avg) // as reset_student_min_course_avg
+                {
+                    min_avg = avg;
+                    weakest = j;
+                }
+                if (grades_are_validated(total, n_elem, avg))
+                {
+                    mask |= 1u << j;
+                }
+            }
+            cols->masks[i] = mask;
+            cols->min_avgs[i] = weakest == -1 ? GRADE_MAX : min_avg;
+
+            // write back to the student
+            Student *stu = cols->students[i];
+            for (int j = 0; j < n_courses; j++)
+            {
+                stu->f_courses[j].average = course_avgs[j];
+            }
+            stu->course_validation_mask = mask;
+            stu->min_course_avg = cols->min_avgs[i];
+            stu->weakest_course = weakest;
+        }
+
+        // general averages of the block, several rows at a time (each one is summed in the same
+        // order and precision as get_student_general_avg)
+        float total_grades[EVALUATE_BLOCK_ROWS];
+        float total_coefs[EVALUATE_BLOCK_ROWS];
+        weighted_sums_in_range(cols->course_avgs + (long)block * n_courses, n_courses,
+                               block_end - block, cols->coefs, GRADE_MIN, GRADE_MAX, total_grades,
+                               total_coefs);
+        for (int i = block; i < block_end; i++)
+        {
+            float total_grade = total_grades[i - block];
+            float total_coef = total_coefs[i - block];
+            cols->averages[i] = total_coef > 0 ? total_grade / total_coef : -1;
+            Student *stu = cols->students[i];
+            stu->average = cols->averages[i];
+        }
+    }
+}
+
+void promotion_columns_evaluate(Promotion_columns *cols)
+{
+    assert(cols && !cols->grades_are_stale);
+    evaluate_rows(cols, 0, cols->n_rows);
+    cols->validated_is_stale = true;
+}
+
+/// @brief Range of rows evaluated by one thread
+typedef struct rows_range
+{
+    Promotion_columns *cols; //!< The columns
+    int begin;               //!< First row of the range
+    int end;                 //!< One past the last row of the range
+} Rows_range;
+
+/// @brief Thread evaluating a Rows_range
+static void *evaluate_rows_range(void *arg)
+{
+    Rows_range *range = (Rows_range *)arg;
+    evaluate_rows(range->cols, range->begin, range->end);
+    return NULL;
+}
+
+void promotion_columns_evaluate_parallel(Promotion_columns *cols, int n_threads)
+{
+    assert(cols && !cols->grades_are_stale);
+    n_threads = get_n_threads(n_threads);
+    if (n_threads > cols->n_rows / PARALLEL_EVALUATE_MIN_ROWS)
+    {
+        n_threads = cols->n_rows / PARALLEL_EVALUATE_MIN_ROWS;
+    }
+    cols->validated_is_stale = true;
+    if (n_threads <= 1)
+    {
+        evaluate_rows(cols, 0, cols->n_rows); // not worth the threads
+        return;
+    }
+    // static partition in contiguous ranges : rows cost about the same, and each thread reads
+    // and writes its own part of every column
+    Rows_range ranges[MAX_THREADS];
+    for (int i = 0; i < n_threads; i++)
+    {
+        ranges[i] = (Rows_range){.cols = cols,
+                                 .begin = (int)((long)cols->n_rows * i / n_threads),
+                                 .end = (int)((long)cols->n_rows * (i + 1) / n_threads)};
+    }
+    run_threads(evaluate_rows_range, ranges, sizeof(Rows_range), n_threads);
+}
+
+void promotion_columns_update_student(Promotion_columns *cols, Student *stu, int course_index)
+{
+    assert(cols && stu && course_index > -1 && course_index < cols->n_courses);
+    int row = stu->row;
+    assert(row > -1 && row < cols->n_rows && cols->students[row] == stu);
+    cols->course_avgs[(long)row * cols->n_courses + course_index] =
+            stu->f_courses[course_index].average;
+    cols->averages[row] = stu->average;
+    cols->masks[row] = stu->course_validation_mask;
+    cols->min_avgs[row] = stu->min_course_avg;
+    if (!cols->validated_is_stale)
+    {
+        __uint64_t bit = (__uint64_t)1 << (row % VALIDATION_WORD_BITS);
+        __uint64_t *word = cols->validated + course_index * (long)cols->n_validation_words +
+                           row / VALIDATION_WORD_BITS;
+        *word = stu->course_validation_mask & (1u << course_index) ? *word | bit : *word & ~bit;
+    }
+    cols->grades_are_stale = true;
+}
+
+/// @brief Rebuild the validation bitmaps from the bitmasks of the rows, if they are stale
+/// @param cols the columns
+static void update_validation_bitmaps(Promotion_columns *cols)
+{
+    if (!cols->validated_is_stale)
+    {
+        return;
+    }
+    // one word of every bitmap at a time : VALIDATION_WORD_BITS bitmasks are transposed
+    for (int w = 0; w < cols->n_validation_words; w++)
+    {
+        __uint64_t words[MAX_FOLLOWED_COURSES] = {0};
+        int begin = w * VALIDATION_WORD_BITS;
+        int end = begin + VALIDATION_WORD_BITS < cols->n_rows ? begin + VALIDATION_WORD_BITS
+                                                              : cols->n_rows;
+        for (int i = begin; i < end; i++)
+        {
+            __uint32_t mask = cols->masks[i];
+            for (int j = 0; j < cols->n_courses; j++) // no branch on the bits
+            {
+                words[j] |= (__uint64_t)(mask >> j & 1) << (i - begin);
+            }
+        }
+        for (int j = 0; j < cols->n_courses; j++)
+        {
+            cols->validated[(long)j * cols->n_validation_words + w] = words[j];
+        }
+    }
+    cols->validated_is_stale = false;
+}
+
+/// @brief Get the word of rows having validated every course of a bitmask
+/// @param cols the columns, bitmaps up to date
+/// @param courses_bitmask the courses, all below n_courses
+/// @param word the index of the word
+/// @return the word, bits past n_rows cleared
+static inline __uint64_t validated_word(const Promotion_columns *cols, __uint32_t courses_bitmask,
+                                        int word)
+{
+    __uint64_t rows = ~(__uint64_t)0;
+    for (__uint32_t mask = courses_bitmask; mask; mask &= mask - 1)
+    {
+        rows &= cols->validated[(long)__builtin_ctz(mask) * cols->n_validation_words + word];
+    }
+    int n_bits = cols->n_rows - word * VALIDATION_WORD_BITS;
+    if (n_bits < VALIDATION_WORD_BITS) // last word
+    {
+        rows &= ((__uint64_t)1 << n_bits) - 1;
+    }
+    return rows;
+}
+
+/// @brief Check if some courses of a bitmask are not in the columns (nobody validated them)
+static inline bool has_unknown_courses(const Promotion_columns *cols, __uint32_t courses_bitmask)
+{
+    return cols->n_courses < MAX_FOLLOWED_COURSES && courses_bitmask >> cols->n_courses;
+}
+
+int promotion_columns_count_validated(Promotion_columns *cols, __uint32_t courses_bitmask)
+{
+    assert(cols);
+    if (has_unknown_courses(cols, courses_bitmask))
+    {
+        return 0;
+    }
+    update_validation_bitmaps(cols);
+    int count = 0;
+    for (int w = 0; w < cols->n_validation_words; w++)
+    {
+        count += __builtin_popcountll(validated_word(cols, courses_bitmask, w));
+    }
+    return count;
+}
+
+int promotion_columns_get_validated(Promotion_columns *cols, __uint32_t courses_bitmask, int *rows)
+{
+    assert(cols && rows);
+    if (has_unknown_courses(cols, courses_bitmask))
+    {
+        return 0;
+    }
+    update_validation_bitmaps(cols);
+    int count = 0;
+    for (int w = 0; w < cols->n_validation_words; w++)
+    {
+        for (__uint64_t word = validated_word(cols, courses_bitmask, w); word; word &= word - 1)
+        {
+            rows[count++] = w * VALIDATION_WORD_BITS + __builtin_ctzll(word);
+        }
+    }
+    return count;
+}
@@ -0,0 +1,124 @@
+#ifndef PROMOTION_COLUMNS_H
+#define PROMOTION_COLUMNS_H
+
+/// @file promotion_columns.h
+/// @brief Columnar (struct of arrays) copy of the data scanned over the whole promotion.
+/// Each student is a row : its id, age, averages and validation bitmask are stored in contiguous
+/// arrays, its course averages in a row of a n_rows x n_courses matrix and its grades in a single
+/// CSR (compressed sparse row) array. Scans over every student (averages evaluation, top students,
+/// sort keys) then read contiguous memory instead of following 4 levels of pointers per grade.\n
+/// The Student structures remain the reference for everything else (names, printing, binary
+/// files) : the columns are built from them and every evaluation is written back to them.
+
+#include "students.h"
+
+#ifndef EVALUATE_N_THREADS
+/// @brief Number of threads used to evaluate the averages of a promotion, 0 to use every online
+/// CPU
+#define EVALUATE_N_THREADS 0
+#endif
+
+#ifndef PARALLEL_EVALUATE_MIN_ROWS
+/// @brief Minimum number of rows evaluated by each thread (smaller columns use fewer threads, or
+/// a single one)
+#define PARALLEL_EVALUATE_MIN_ROWS 16384
+#endif
+
+/// @brief Number of rows in a word of the validation bitmaps
+#define VALIDATION_WORD_BITS 64
+
+/// @brief Columnar data of a promotion. Rows are numbered in the order of the students table when
+/// the columns were built (which sorting doesn't change, see get_sorted_students).
+typedef struct promotion_columns
+{
+    ///@brief number of rows (students)
+    int n_rows;
+    ///@brief number of courses
+    int n_courses;
+    ///@brief student of each row (row of a student : stu->row)
+    Student **students;
+    ///@brief id of each row
+    unsigned int *ids;
+    ///@brief age of each row
+    int *ages;
+    ///@brief general average of each row (-1 if no grades)
+    float *averages;
+    ///@brief course validation bitmask of each row
+    __uint32_t *masks;
+    ///@brief validation bitmaps (vertical copy of masks), n_courses x n_validation_words
+    /// row-major matrix : bit r % VALIDATION_WORD_BITS of the word r / VALIDATION_WORD_BITS of the
+    /// bitmap of a course is set if the row r validated this course (bits past n_rows are 0)
+    __uint64_t *validated;
+    ///@brief number of words of each validation bitmap
+    int n_validation_words;
+    ///@brief true if the validation bitmaps must be rebuilt from masks (they are rebuilt by the
+    /// first query following an evaluation, so that evaluations don't pay for them)
+    bool validated_is_stale;
+    ///@brief minimum course average of each row (see Student.min_course_avg)
+    float *min_avgs;
+    ///@brief course averages, n_rows x n_courses row-major matrix (-1 if no grades)
+    float *course_avgs;
+    ///@brief coef of each course
+    float *coefs;
+    ///@brief CSR offsets (n_rows x n_courses + 1 elements) : with cell = r * n_courses + c, the
+    /// grades of the course c of the row r are grades[grade_offsets[cell]] to
+    /// grades[grade_offsets[cell + 1]] (excluded)
+    long *grade_offsets;
+    ///@brief every grade, by row then course (in insertion order)
+    grade_t *grades;
+    ///@brief true if grades were added to the students since the columns were built (the grades
+    /// and offsets tables are then out of date, averages and bitmasks aren't)
+    bool grades_are_stale;
+} Promotion_columns;
+
+/// @brief Build the columns of a students table. Averages (and minimum course averages) and
+/// bitmasks are copied from the students (they are not evaluated). Every student must follow the n_courses courses of ctab.
+/// The row of each student (stu->row) is set to its index in the table.
+/// @param students table of the students
+/// @param n_students number of students
+/// @param ctab the courses table
+/// @return the allocated columns
+Promotion_columns *init_promotion_columns(Student **students, int n_students, CoursesTab *ctab);
+
+/// @brief Free columns (the students are not freed, their row is reset to -1)
+/// @param cols the columns to free
+void free_promotion_columns(Promotion_columns *cols);
+
+/// @brief Evaluate every course average, general average and validation bitmask from the grades
+/// of the columns, and write them back to the students (with their minimum course averages).
+/// Results are exactly those of get_followed_course_avg, get_student_general_avg,
+/// update_student_bitmask and reset_student_min_course_avg.
+/// @param cols the columns, grades must be up to date
+void promotion_columns_evaluate(Promotion_columns *cols);
+
+/// @brief Same as promotion_columns_evaluate, with the rows split in n_threads contiguous ranges
+/// evaluated concurrently (rows are independent : results are the same)
+/// @param cols the columns, grades must be up to date
+/// @param n_threads the number of threads, 0 to use every online CPU (fewer threads are used if
+/// there are less than PARALLEL_EVALUATE_MIN_ROWS rows per thread)
+void promotion_columns_evaluate_parallel(Promotion_columns *cols, int n_threads);
+
+/// @brief Count the rows having validated every course of a bitmask (like student_has_validated).
+/// The validation bitmaps of these courses are intersected VALIDATION_WORD_BITS rows at a time
+/// (they are rebuilt first if they are stale).
+/// @param cols the columns
+/// @param courses_bitmask the courses (bit i for the course i, 0 matches every row)
+/// @return the number of rows
+int promotion_columns_count_validated(Promotion_columns *cols, __uint32_t courses_bitmask);
+
+/// @brief Get the rows having validated every course of a bitmask (see
+/// promotion_columns_count_validated)
+/// @param cols the columns
+/// @param courses_bitmask the courses
+/// @param rows receives the rows in increasing order (n_rows elements allocated)
+/// @return the number of rows
+int promotion_columns_get_validated(Promotion_columns *cols, __uint32_t courses_bitmask, int *rows);
+
+/// @brief Copy the averages and bitmask of a student to its row, after a grade was added to the
+/// course course_index (see apply_grade_to_student). The grades of the columns become stale.
+/// @param cols the columns
+/// @param stu the student (in the columns)
+/// @param course_index the index of the course the grade was added to
+void promotion_columns_update_student(Promotion_columns *cols, Student *stu, int course_index);
+
+#endif
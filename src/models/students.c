@@ -3,32 +3,51 @@
 #include "students.h"
 #include "../other/utils.h"
 
-Student *init_student(char *name, char *first_name, unsigned int student_id, int n_courses, int age)
+Student *init_student(char *name, char *first_name, unsigned int student_id, int n_courses, int age,
+                      Arena *arena, String_pool *names)
 {
     assert(name);
     assert(first_name);
+    assert(!names || (arena && names->arena == arena));
     assert(age_is_valid(age));
     assert(n_courses > -1);
-    Student *stu = malloc(sizeof(Student));
+    Student *stu = arena ? arena_alloc(arena, sizeof(Student)) : malloc(sizeof(Student));
     verify(stu, "malloc error");
     stu->id = student_id;
+    stu->row = -1;
     stu->average = -1;
     stu->age = age;
     stu->n_courses = n_courses;
     stu->course_validation_mask = 0;
+    stu->min_course_avg = GRADE_MAX; // set with the course averages
+    stu->weakest_course = -1;
     if (n_courses > 0)
     {
         // IF n_courses is known, it is supposed sufficiently constant so that we don't need to
         // reallocate to many times
-        stu->f_courses = (Followed_course **)calloc(
-                n_courses, sizeof(Followed_course *)); // init at NULL for safety
-        verify(stu->f_courses, "calloc error");
+        size_t f_courses_size = n_courses * sizeof(Followed_course);
+        stu->f_courses = (Followed_course *)(arena ? arena_alloc(arena, f_courses_size)
+                                                   : malloc(f_courses_size));
+        verify(stu->f_courses, "malloc error");
+        memset(stu->f_courses, 0, f_courses_size); // grades at NULL for safety
     }
     else
     {
         stu->f_courses =
                 NULL; // we don't know how many courses a student will follow yet (but will later)
     }
+    if (names)
+    {
+        stu->fname = (char *)string_pool_intern(names, first_name, strlen(first_name));
+        stu->name = (char *)string_pool_intern(names, name, strlen(name));
+        return stu;
+    }
+    if (arena)
+    {
+        stu->fname = arena_strdup(arena, first_name);
+        stu->name = arena_strdup(arena, name);
+        return stu;
+    }
     int name_len = strlen(name);
     int fname_len = strlen(first_name);
     stu->fname = (char *)malloc((fname_len + 1) * sizeof(char));
@@ -39,20 +58,52 @@ Student *init_student(char *name, char *first_name, unsigned int student_id, int
     return stu;
 }
 
-void add_grade_to_student(Student *stu, CoursesTab *ctab, char *course_name, float grade)
+void add_grade_to_student(Student *stu, CoursesTab *ctab, char *course_name, grade_t grade,
+                          Arena *arena)
 {
-    assert(grade_is_valid(grade));
+    assert(stored_grade_is_valid(grade));
     assert(student_is_valid(stu));
     long i = get_course_index_in_table(ctab, course_name);
     verify(i > -1, "course not found in courses table");
-    Followed_course *fcourse = stu->f_courses[i];
     // recalculating avg supposing that all grades have same coef
-    Grades_push(grade, fcourse->grades);
-    //!\ to recalculate the average EACH time a grade is added (not recommended for performances +
-    //! implementation)
-    // uncomment the following line :
-    // fcourse->average = get_followed_course_avg(fcourse);
-    // stu->average = get_student_general_avg(stu, ctab);
+    add_grade_to_student_by_index(stu, i, grade, arena);
+    // to update the averages each time a grade is added, use apply_grade_to_student (O(1))
+}
+
+void apply_grade_to_student(Student *stu, CoursesTab *ctab, int course_index, grade_t grade,
+                            Arena *arena)
+{
+    assert(stored_grade_is_valid(grade));
+    assert(stu && ctab && course_index > -1 && course_index < ctab->size);
+    Followed_course *fcourse = &stu->f_courses[course_index];
+    float old_avg = fcourse->average;
+    add_grade_to_student_by_index(stu, course_index, grade, arena);
+    fcourse->average = get_followed_course_running_avg(fcourse);
+
+    // summed again in course order (not updated by subtraction) : same bits as an evaluation
+    stu->average = get_student_general_avg(stu, ctab);
+
+    if (followed_course_is_validated(fcourse))
+    {
+        stu->course_validation_mask |= 1u << course_index;
+    }
+    else
+    {
+        stu->course_validation_mask &= ~(1u << course_index);
+    }
+
+    // minimum course average : a scan is only needed when the weakest course got better
+    float avg = fcourse->average;
+    if (avg < stu->min_course_avg ||
+        (avg == stu->min_course_avg && course_index < stu->weakest_course))
+    {
+        stu->min_course_avg = avg;
+        stu->weakest_course = course_index;
+    }
+    else if (course_index == stu->weakest_course && avg != old_avg)
+    {
+        reset_student_min_course_avg(stu);
+    }
 }
 // #define PRINT_STUDENT_COURSES
 void print_student(Student *stu)
@@ -70,7 +121,7 @@ void print_student(Student *stu)
     for (int i = 0; i < stu->n_courses; i++)
     {
         printf(BOLD_BLU "\n%d - " RESET, i);
-        print_fcourse(stu->f_courses[i]);
+        print_fcourse(&stu->f_courses[i]);
     }
 }
 
@@ -107,8 +158,7 @@ void free_student(Student *stu)
     stu->fname = stu->name = NULL;
     for (int i = 0; i < stu->n_courses; i++)
     {
-        free_followed_course(stu->f_courses[i]);
-        stu->f_courses[i] = NULL;
+        clear_followed_course(&stu->f_courses[i]);
     }
     free(stu->f_courses);
     stu->f_courses = NULL;
@@ -155,20 +205,27 @@ bool student_is_valid(Student *stu)
         }
         for (int i = 0; i < n_courses; i++)
         {
-            if (!followed_course_is_valid(stu->f_courses[i]))
+            if (!followed_course_is_valid(&stu->f_courses[i]))
             {
                 return false;
             }
         }
-        if ((stu->course_validation_mask & ~((1U << n_courses) - 1)) !=
-            0) // check that no invalid bits are set
+        if (n_courses > MAX_FOLLOWED_COURSES)
+        {
+            fprintf(stderr, BOLD_RED "WARNING : number of courses %d above %d\n" RESET, n_courses,
+                    MAX_FOLLOWED_COURSES);
+            return false;
+        }
+        // computed on 64 bits : 1U << 32 is undefined
+        __uint32_t valid_bits = (__uint32_t)(((__uint64_t)1 << n_courses) - 1);
+        if ((stu->course_validation_mask & ~valid_bits) != 0) // check that no invalid bits are set
         {
-            // note : could have use YEAR_MASK instead of (1U << n_courses) - 1)
+            // note : could have use YEAR_MASK instead of valid_bits
             fprintf(stderr,
                     BOLD_RED "WARNING : student course validation bitmask has invalid "
                              "bits set (n_courses = %d, bitmask = 0x%X, valid bits mask = "
                              "0x%X,YEAR_MASK : 0x%X)\n" RESET,
-                    n_courses, stu->course_validation_mask, (1U << n_courses) - 1, YEAR_MASK);
+                    n_courses, stu->course_validation_mask, valid_bits, YEAR_MASK);
             return false;
         }
     }
@@ -184,17 +241,17 @@ bool student_is_valid(Student *stu)
 void update_student_bitmask(Student *stu)
 {
     assert(student_is_valid(stu));
-    Followed_course **tab = stu->f_courses;
+    Followed_course *tab = stu->f_courses;
     for (int i = 0; i < stu->n_courses; i++)
     {
         // set i-th bit to 0 or 1 depending on if course is validated
-        if (tab[i]->average >= GRADE_TO_VALIDATE)
+        if (followed_course_is_validated(&tab[i]))
         {
-            stu->course_validation_mask |= 1 << i;
+            stu->course_validation_mask |= 1u << i;
         }
         else
         {
-            stu->course_validation_mask &= ~(1 << i);
+            stu->course_validation_mask &= ~(1u << i);
         }
     }
 }
\ No newline at end of file
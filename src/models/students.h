@@ -9,6 +9,7 @@
 #include "course.h"
 #include "followed_course.h"
 #include "../other/utils.h"
+#include "../other/string_pool.h"
 
 /// @brief Define to print the followed courses when printing a student
 // #define PRINT_STUDENT_COURSES
@@ -22,10 +23,14 @@
 #define AGE_MAX 100
 #endif
 
+/// @brief Maximum number of courses followed by a student (one bit each in the validation bitmask)
+#define MAX_FOLLOWED_COURSES 32
+
 /// @brief Structure representing a student.
 /// We suppose here that every student follows the same number of courses (n_courses).
 /// In the f_courses table, the courses are stored in the same order as in the CoursesTab of the
-/// promotion.
+/// promotion. They are stored inline (one contiguous block per student), so that scanning the
+/// averages of a student stays in one or two cache lines.
 typedef struct student
 {
     ///@brief bitmask representing validated courses\n
@@ -34,11 +39,11 @@ typedef struct student
     /// used to quickly check if a student has validated a set of courses
     /// (see student_has_validated function)
     __uint32_t course_validation_mask;
-    ///@brief table of followed courses, **is ordered alphabetically**
-    Followed_course **f_courses;
-    ///@brief last name
+    ///@brief table of the n_courses followed courses (stored inline), **is ordered alphabetically**
+    Followed_course *f_courses;
+    ///@brief last name (shared with the students of the same name if interned, see init_student)
     char *name;
-    ///@brief first name
+    ///@brief first name (shared with the students of the same first name if interned)
     char *fname;
     ///@brief duplicated information if n_courses followed is constant
     int n_courses;
@@ -46,8 +51,18 @@ typedef struct student
     int age;
     ///@brief general average of the student over all followed courses
     float average;
+    ///@brief minimum course average (courses without grades count as -1), GRADE_MAX if the student
+    /// follows no course. Kept up to date with the course averages (see
+    /// reset_student_min_course_avg), it is the key of the MINIMUM sorting mode.
+    float min_course_avg;
+    ///@brief index of the (first) course whose average is min_course_avg, -1 if the student
+    /// follows no course
+    int weakest_course;
     ///@brief unique identifier of the student
     unsigned int id;
+    ///@brief row of the student in the columns of its promotion (see promotion_columns.h), -1 if
+    /// the student isn't in any columns
+    int row;
 } Student;
 
 /// @brief Initialise a student, its followed courses are initialised to NULL and n_courses to 0.
@@ -57,11 +72,16 @@ typedef struct student
 /// @param student_id the unique identifier of the student
 /// @param n_courses the number of courses the student will follow
 /// @param age the age of the student
+/// @param arena the arena to allocate the student (and its names and courses table) in, NULL to
+/// use malloc (the student is then freed with free_student)
+/// @param names pool to intern the names and first names in (allocated in arena), NULL to copy
+/// them. Interned names must not be modified.
 /// @return the allocated student
 Student *init_student(char *name, char *first_name, unsigned int student_id, int n_courses,
-                      int age);
+                      int age, Arena *arena, String_pool *names);
 
-/// @brief Free a student and all its followed courses
+/// @brief Free a student and all its followed courses (allocated with malloc, students allocated in
+/// an arena are freed with it)
 /// @param stu the student to free
 void free_student(Student *stu);
 
@@ -70,7 +90,35 @@ void free_student(Student *stu);
 /// @param ctab the courses table (to get the index of the course)
 /// @param course_name the name of the course
 /// @param grade the grade to add
-void add_grade_to_student(Student *stu, CoursesTab *ctab, char *course_name, float grade);
+/// @param arena the arena owning the student, NULL if it was allocated with malloc
+void add_grade_to_student(Student *stu, CoursesTab *ctab, char *course_name, grade_t grade,
+                          Arena *arena);
+
+/// @brief Add a grade to a student given the index of the course in the courses table (no name
+/// resolution, meant for loading loops), note that the average is not updated
+/// @param stu the student
+/// @param course_index the index of the course in the courses table (and in stu->f_courses)
+/// @param grade the grade to add
+/// @param arena the arena owning the student, NULL if it was allocated with malloc
+static inline void add_grade_to_student_by_index(Student *stu, int course_index, grade_t grade,
+                                                 Arena *arena)
+{
+    assert(stu && course_index > -1 && course_index < stu->n_courses);
+    followed_course_add_grade(&stu->f_courses[course_index], grade, arena);
+}
+
+/// @brief Add a grade to a student and update in O(1) the course average, the general average
+/// and the validation bitmask of the student. The course average is exactly the one
+/// get_followed_course_avg would give, and the general average is recomputed from the course
+/// averages with get_student_general_avg (at most MAX_FOLLOWED_COURSES terms) : both don't depend
+/// on the order the grades were added in.
+/// @param stu the student
+/// @param ctab the courses table (for the coef of the course)
+/// @param course_index the index of the course in the courses table (and in stu->f_courses)
+/// @param grade the grade to add
+/// @param arena the arena owning the student, NULL if it was allocated with malloc
+void apply_grade_to_student(Student *stu, CoursesTab *ctab, int course_index, grade_t grade,
+                            Arena *arena);
 
 /// @brief Get the general average of a student given its followed courses and the courses table.
 /// Does not take into account followed courses with invalid average.
@@ -83,17 +131,36 @@ static inline float get_student_general_avg(Student *stu, CoursesTab *ctab)
     float total_coef = 0;
     for (int i = 0; i < ctab->size; i++)
     {
-        float avg = stu->f_courses[i]->average;
+        float avg = stu->f_courses[i].average;
         if (avg > GRADE_MIN && avg < GRADE_MAX)
         {
             float coef = ctab->tab[i]->coef;
-            total_grade += stu->f_courses[i]->average * coef;
+            total_grade += stu->f_courses[i].average * coef;
             total_coef += coef;
         }
     }
     return total_coef > 0 ? total_grade / total_coef : -1;
 }
 
+/// @brief Reset the minimum course average of a student and its weakest course from its course
+/// averages
+/// @param stu the student
+static inline void reset_student_min_course_avg(Student *stu)
+{
+    float min = GRADE_MAX;
+    int weakest = -1;
+    for (int i = 0; i < stu->n_courses; i++)
+    {
+        if (weakest == -1 || stu->f_courses[i].average < min)
+        {
+            min = stu->f_courses[i].average;
+            weakest = i;
+        }
+    }
+    stu->min_course_avg = weakest == -1 ? GRADE_MAX : min;
+    stu->weakest_course = weakest;
+}
+
 /// @brief Check if an age is valid
 /// This function prints invalidity reasons to stderr.
 /// @param age the age to check
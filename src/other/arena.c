@@ -0,0 +1,141 @@
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "arena.h"
+#include "utils.h"
+
+/// @brief Round size up to a multiple of ARENA_ALIGN
+static inline size_t align_size(size_t size)
+{
+    return (size + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+}
+
+/// @brief Size of a block header, rounded so that the data stays aligned
+#define BLOCK_HEADER_SIZE align_size(sizeof(Arena_block))
+
+/// @brief First byte available for allocations in a block
+static inline char *block_data(Arena_block *block) { return (char *)block + BLOCK_HEADER_SIZE; }
+
+Arena *init_arena(size_t first_block_size)
+{
+    Arena *arena = (Arena *)malloc(sizeof(Arena));
+    verify(arena, "malloc error");
+    arena->blocks = NULL;
+    arena->next_block_size = first_block_size > 0 ? first_block_size : ARENA_FIRST_BLOCK_SIZE;
+    arena->total_used = 0;
+    arena->n_blocks = 0;
+    return arena;
+}
+
+void free_arena(Arena *arena)
+{
+    assert(arena);
+    Arena_block *block = arena->blocks;
+    while (block)
+    {
+        Arena_block *next = block->next;
+        free(block);
+        block = next;
+    }
+    free(arena);
+}
+
+/// @brief Push a new block of at least min_capacity bytes at the head of the arena
+static void arena_new_block(Arena *arena, size_t min_capacity)
+{
+    size_t capacity = arena->next_block_size;
+    if (capacity < min_capacity)
+    {
+        capacity = min_capacity;
+    }
+    capacity = align_size(capacity);
+    Arena_block *block = (Arena_block *)malloc(BLOCK_HEADER_SIZE + capacity);
+    verify(block, "malloc error");
+    block->capacity = capacity;
+    block->used = 0;
+    block->next = arena->blocks;
+    arena->blocks = block;
+    arena->n_blocks++;
+    if (arena->next_block_size < ARENA_MAX_BLOCK_SIZE)
+    {
+        arena->next_block_size *= 2;
+    }
+}
+
+void *arena_alloc(Arena *arena, size_t size)
+{
+    assert(arena);
+    size = align_size(size > 0 ? size : 1);
+    Arena_block *block = arena->blocks;
+    if (!block || block->capacity - block->used < size)
+    {
+        arena_new_block(arena, size);
+        block = arena->blocks;
+    }
+    void *ptr = block_data(block) + block->used;
+    block->used += size;
+    arena->total_used += size;
+    return ptr;
+}
+
+void *arena_realloc(Arena *arena, void *ptr, size_t old_size, size_t new_size)
+{
+    assert(arena);
+    if (!ptr)
+    {
+        return arena_alloc(arena, new_size);
+    }
+    Arena_block *block = arena->blocks;
+    size_t old_aligned = align_size(old_size > 0 ? old_size : 1);
+    size_t new_aligned = align_size(new_size > 0 ? new_size : 1);
+    // last allocation of the current block : resize in place if possible
+    if (block && (char *)ptr + old_aligned == block_data(block) + block->used &&
+        block->used - old_aligned + new_aligned <= block->capacity)
+    {
+        block->used = block->used - old_aligned + new_aligned;
+        arena->total_used = arena->total_used - old_aligned + new_aligned;
+        return ptr;
+    }
+    void *new_ptr = arena_alloc(arena, new_size);
+    memcpy(new_ptr, ptr, old_size < new_size ? old_size : new_size);
+    return new_ptr;
+}
+
+char *arena_strdup(Arena *arena, const char *str)
+{
+    assert(arena && str);
+    size_t len = strlen(str);
+    char *copy = (char *)arena_alloc(arena, len + 1);
+    memcpy(copy, str, len + 1);
+    return copy;
+}
+
+void arena_adopt(Arena *dst, Arena *src)
+{
+    assert(dst && src && dst != src);
+    if (!src->blocks)
+    {
+        return;
+    }
+    // src blocks are put behind the current block of dst, which keeps receiving allocations
+    Arena_block *last = src->blocks;
+    while (last->next)
+    {
+        last = last->next;
+    }
+    if (dst->blocks)
+    {
+        last->next = dst->blocks->next;
+        dst->blocks->next = src->blocks;
+    }
+    else
+    {
+        dst->blocks = src->blocks;
+    }
+    dst->total_used += src->total_used;
+    dst->n_blocks += src->n_blocks;
+    src->blocks = NULL;
+    src->total_used = 0;
+    src->n_blocks = 0;
+}
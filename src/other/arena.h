@@ -0,0 +1,84 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+/// @file arena.h
+/// @brief Region (arena) allocator : allocations are carved out of large blocks and are all freed
+/// at once with the arena. Used to back a whole promotion (students, names, followed courses and
+/// grades), so that loading one makes a handful of large allocations and freeing it only releases
+/// the blocks.\n
+/// An arena is not thread safe : threads allocate in their own arena, merged afterward (see
+/// arena_adopt).
+
+#include <stddef.h>
+
+#ifndef ARENA_FIRST_BLOCK_SIZE
+/// @brief Size (in bytes) of the first block of an arena (0 given to init_arena)
+#define ARENA_FIRST_BLOCK_SIZE (64 * 1024)
+#endif
+
+#ifndef ARENA_MAX_BLOCK_SIZE
+/// @brief Block sizes double up to this size (in bytes), bigger allocations get their own block
+#define ARENA_MAX_BLOCK_SIZE (64 * 1024 * 1024)
+#endif
+
+#ifndef ARENA_ALIGN
+/// @brief Alignment (in bytes) of every allocation
+#define ARENA_ALIGN 8
+#endif
+
+/// @brief A block of memory, allocations are carved out of it from its start
+typedef struct arena_block
+{
+    struct arena_block *next; //!< Previously filled block
+    size_t capacity;          //!< Number of bytes available after the header
+    size_t used;              //!< Number of bytes already allocated
+} Arena_block;
+
+/// @brief Region allocator, owning a list of blocks
+typedef struct arena
+{
+    Arena_block *blocks;    //!< Current block (head of the list), NULL before the first allocation
+    size_t next_block_size; //!< Capacity of the next block
+    size_t total_used;      //!< Number of allocated bytes (statistics)
+    int n_blocks;           //!< Number of blocks (statistics)
+} Arena;
+
+/// @brief Create an empty arena (no block is allocated yet)
+/// @param first_block_size capacity of the first block in bytes, 0 for ARENA_FIRST_BLOCK_SIZE (a
+/// good estimation of the total need saves blocks)
+/// @return the allocated arena
+Arena *init_arena(size_t first_block_size);
+
+/// @brief Free an arena and everything allocated in it, in O(number of blocks)
+/// @param arena the arena to free
+void free_arena(Arena *arena);
+
+/// @brief Allocate memory in an arena (exit on error). The memory is NOT initialised.
+/// @param arena the arena
+/// @param size the number of bytes
+/// @return the allocated memory (aligned on ARENA_ALIGN), freed with the arena
+void *arena_alloc(Arena *arena, size_t size);
+
+/// @brief Grow (or shrink) an allocation of an arena. The last allocation of the current block is
+/// resized in place when it fits, otherwise the content is copied to a new allocation (the old one
+/// is only released with the arena).
+/// @param arena the arena
+/// @param ptr the allocation to resize (allocated in arena), NULL to allocate
+/// @param old_size the current size of the allocation
+/// @param new_size the wished size
+/// @return the resized allocation
+void *arena_realloc(Arena *arena, void *ptr, size_t old_size, size_t new_size);
+
+/// @brief Copy a string in an arena
+/// @param arena the arena
+/// @param str the string to copy
+/// @return the copy, freed with the arena
+char *arena_strdup(Arena *arena, const char *str);
+
+/// @brief Move every block of src in dst (O(number of blocks of src)). src is left empty and can
+/// be freed or reused. Allocations of src stay valid and are now owned by dst.
+/// @param dst the arena receiving the blocks
+/// @param src the arena giving its blocks
+void arena_adopt(Arena *dst, Arena *src);
+
+#endif
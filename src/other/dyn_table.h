@@ -12,6 +12,30 @@
 #include <stdlib.h>
 #include <string.h>
 
+#ifndef DYN_TABLE_GROWTH
+/// @brief Growth policy of the dynamic tables : new capacity of a full table of the given capacity
+/// (must be greater than capacity)
+#define DYN_TABLE_GROWTH(capacity) ((capacity) * 2 + 1)
+#endif
+
+/// DECLARE_DYN_TABLE_VIEW declares a dynamic table whose storage is managed by its owner (e.g. kept
+/// inline in another structure or allocated in an arena) : only the structure and the functions
+/// that never allocate nor free the table are generated (_clear, _sort, _print, _save_to_bin and
+/// _is_valid, see DECLARE_DYN_TABLE). Pair it with DEFINE_DYN_TABLE_VIEW.
+#define DECLARE_DYN_TABLE_VIEW(Type, Name)                                                         \
+    typedef struct Name                                                                            \
+    {                                                                                              \
+        Type *tab;                                                                                 \
+        int capacity;                                                                              \
+        int size;                                                                                  \
+    } Name;                                                                                        \
+                                                                                                   \
+    void Name##_clear(Name *table);                                                                \
+    void Name##_sort(Name *tab, int (*compare_function)(const void *, const void *));              \
+    void Name##_print(Name *tab, void (*print_elem)(Type));                                        \
+    void Name##_save_to_bin(Name *tab, FILE *file, void (*save_elem)(Type, FILE *));               \
+    bool Name##_is_valid(Name *dtab, bool (*elem_is_valid)(Type));
+
 /// DECLARE_DYN_TABLE should be put in the header file where we would want to declare
 /// a dynamic table structure that reallocate itself as needed.
 /// @param Type the type of the elements stored in the dynamic table
@@ -22,7 +46,13 @@
 /// Functions generated:
 /// - StudentsTab* StudentsTab_init();
 /// - void StudentsTab_push(Student* value, StudentsTab* table) : adds an element to the dynamic
-/// table
+/// table (growing it with DYN_TABLE_GROWTH when full)
+/// - void StudentsTab_reserve(StudentsTab* table, int capacity) : makes room for at least
+/// capacity elements (exactly capacity if the table has to grow)\n
+/// - void StudentsTab_push_n(Student* const* values, int n, StudentsTab* table) : appends n
+/// elements at once (memcpy, the elements must be plain data)\n
+/// - void StudentsTab_shrink_to_fit(StudentsTab* table) : releases the unused capacity\n
+/// - void StudentsTab_clear(StudentsTab* table) : empties the table, keeping its capacity\n
 /// - void StudentsTab_free(StudentsTab* tab, void (*free_elem)(Student*)) :
 /// frees the dynamic table and its elements using the provided free function\n
 /// - void StudentsTab_sort(StudentsTab* tab, int (*compare_function)(const void*, const void*)) :
@@ -34,67 +64,25 @@
 /// - StudentsTab* StudentsTab_load_from_bin(FILE* file, Student* (*load_elem)(FILE*)) :
 /// loads the dynamic table from a binary file using the provided load function
 #define DECLARE_DYN_TABLE(Type, Name)                                                              \
-    typedef struct Name                                                                            \
-    {                                                                                              \
-        Type *tab;                                                                                 \
-        int capacity;                                                                              \
-        int size;                                                                                  \
-    } Name;                                                                                        \
+    DECLARE_DYN_TABLE_VIEW(Type, Name)                                                             \
                                                                                                    \
     Name *Name##_init();                                                                           \
     void Name##_push(Type value, Name *table);                                                     \
+    void Name##_reserve(Name *table, int capacity);                                                \
+    void Name##_push_n(Type const *values, int n, Name *table);                                    \
+    void Name##_shrink_to_fit(Name *table);                                                        \
     void Name##_free(Name *tab, void (*free_elem)(Type));                                          \
-    void Name##_sort(Name *tab, int (*compare_function)(const void *, const void *));              \
-    void Name##_print(Name *tab, void (*print_elem)(Type));                                        \
-    void Name##_save_to_bin(Name *tab, FILE *file, void (*save_elem)(Type, FILE *));               \
-    Name *Name##_load_from_bin(FILE *file, Type (*load_elem)(FILE *));                             \
-    bool Name##_is_valid(Name *dtab, bool (*elem_is_valid)(Type));
+    Name *Name##_load_from_bin(FILE *file, Type (*load_elem)(FILE *));
 
-/// DEFINE_DYN_TABLE should be put in the C file where we would want to define
-/// the functions of a dynamic table structure that reallocate itself as needed.
+/// DEFINE_DYN_TABLE_VIEW should be put in the C file defining the functions of a dynamic table
+/// declared with DECLARE_DYN_TABLE_VIEW (DEFINE_DYN_TABLE includes it).
 /// @param Type the type of the elements stored in the dynamic table
 /// @param Name the name of the dynamic table structure
-#define DEFINE_DYN_TABLE(Type, Name)                                                               \
-    Name *Name##_init()                                                                            \
-    {                                                                                              \
-        Name *td = malloc(sizeof(Name));                                                           \
-        verify(td, "malloc error");                                                                \
-        td->capacity = 0;                                                                          \
-        td->size = 0;                                                                              \
-        td->tab = NULL;                                                                            \
-        return td;                                                                                 \
-    }                                                                                              \
-    void Name##_push(Type value, Name *table)                                                      \
+#define DEFINE_DYN_TABLE_VIEW(Type, Name)                                                          \
+    void Name##_clear(Name *table)                                                                 \
     {                                                                                              \
         assert(table);                                                                             \
-        if (table->size >= table->capacity)                                                        \
-        {                                                                                          \
-            table->capacity = table->capacity * 2 + 1;                                             \
-            Type *new_tab = (Type *)realloc(table->tab, table->capacity * sizeof(Type));           \
-            verify(new_tab != NULL, "realloc error");                                              \
-            table->tab = new_tab;                                                                  \
-        }                                                                                          \
-        table->tab[table->size] = value;                                                           \
-        table->size += 1;                                                                          \
-    }                                                                                              \
-                                                                                                   \
-    void Name##_free(Name *tab, void (*free_elem)(Type))                                           \
-    {                                                                                              \
-        if (tab == NULL)                                                                           \
-        {                                                                                          \
-            fprintf(stderr, BOLD_RED "WARNING : dynamic table struct %s is NULL\n" RESET, #Name);  \
-            return;                                                                                \
-        }                                                                                          \
-        if (free_elem != NULL)                                                                     \
-        {                                                                                          \
-            for (int i = 0; i < tab->size; i++)                                                    \
-            {                                                                                      \
-                free_elem(tab->tab[i]);                                                            \
-            }                                                                                      \
-        }                                                                                          \
-        free(tab->tab);                                                                            \
-        tab->tab = NULL;                                                                           \
-        free(tab);                                                                                 \
+        table->size = 0;                                                                           \
     }                                                                                              \
                                                                                                    \
     void Name##_sort(Name *tab, int (*compare_function)(const void *, const void *))               \
@@ -118,6 +106,7 @@
         }                                                                                          \
         putchar('\n');                                                                             \
     }                                                                                              \
+                                                                                                   \
     void Name##_save_to_bin(Name *dtab, FILE *file, void (*save_elem)(Type, FILE *))               \
     {                                                                                              \
         assert(dtab && file);                                                                      \
@@ -140,39 +129,7 @@
             }                                                                                      \
         }                                                                                          \
     }                                                                                              \
-    Name *Name##_load_from_bin(FILE *file, Type (*load_elem)(FILE *))                              \
-    {                                                                                              \
-        assert(file);                                                                              \
-        Name *dtab = Name##_init();                                                                \
-        assert(dtab);                                                                              \
-        verify(fread(&(dtab->capacity), sizeof(int), 1, file) == 1,                                \
-               "couldn't load dynamic table capacity (int) while loading from binary");            \
-        verify(fread(&(dtab->size), sizeof(int), 1, file) == 1,                                    \
-               "couldn't load dynamic table size (int) while loading from binary");                \
                                                                                                    \
-        dtab->tab = (Type *)malloc(dtab->capacity * sizeof(Type));                                 \
-        assert(dtab->tab);                                                                         \
-        if (load_elem == NULL)                                                                     \
-        {                                                                                          \
-            /*We assume that if load_elem is NULL, the table does not contain any pointer*/        \
-            if (fread(dtab->tab, sizeof(Type), dtab->size, file) != (size_t)dtab->size)            \
-            {                                                                                      \
-                printf("couldn't load dynamic table content while loading from binary");           \
-                perror("fread\n");                                                                 \
-                printf("feof : %d\n", feof(file));                                                 \
-                exit(1);                                                                           \
-            }                                                                                      \
-        }                                                                                          \
-        else                                                                                       \
-        {                                                                                          \
-            /*Otherwise, we need to do the load of the table manually*/                            \
-            for (int i = 0; i < dtab->size; i++)                                                   \
-            {                                                                                      \
-                dtab->tab[i] = load_elem(file);                                                    \
-            }                                                                                      \
-        }                                                                                          \
-        return dtab;                                                                               \
-    }                                                                                              \
     bool Name##_is_valid(Name *dtab, bool (*elem_is_valid)(Type))                                  \
     {                                                                                              \
         if (!dtab)                                                                                 \
@@ -216,15 +173,361 @@
                 }                                                                                  \
             }                                                                                      \
         }                                                                                          \
-        else if (tab) /*and size ==0*/                                                             \
+        else if (tab && cap == 0) /*an empty table may keep its storage, not a 0 capacity one*/   \
         {                                                                                          \
             fprintf(stderr,                                                                        \
                     BOLD_RED "WARNING : table (type %s*) of dtab (type %s*) is supposed null if "  \
-                             "table size is 0\n" RESET,                                            \
+                             "table capacity is 0\n" RESET,                                        \
                     #Type, #Name);                                                                 \
             return false;                                                                          \
         }                                                                                          \
         return true;                                                                               \
     }
 
+/// DEFINE_DYN_TABLE should be put in the C file where we would want to define
+/// the functions of a dynamic table structure that reallocate itself as needed.
+/// @param Type the type of the elements stored in the dynamic table
+/// @param Name the name of the dynamic table structure
+#define DEFINE_DYN_TABLE(Type, Name)                                                               \
+    DEFINE_DYN_TABLE_VIEW(Type, Name)                                                              \
+                                                                                                   \
+    Name *Name##_init()                                                                            \
+    {                                                                                              \
+        Name *td = malloc(sizeof(Name));                                                           \
+        verify(td, "malloc error");                                                                \
+        td->capacity = 0;                                                                          \
+        td->size = 0;                                                                              \
+        td->tab = NULL;                                                                            \
+        return td;                                                                                 \
+    }                                                                                              \
+                                                                                                   \
+    void Name##_push(Type value, Name *table)                                                      \
+    {                                                                                              \
+        assert(table);                                                                             \
+        if (table->size >= table->capacity)                                                        \
+        {                                                                                          \
+            Name##_reserve(table, DYN_TABLE_GROWTH(table->capacity));                              \
+        }                                                                                          \
+        table->tab[table->size] = value;                                                           \
+        table->size += 1;                                                                          \
+    }                                                                                              \
+                                                                                                   \
+    void Name##_reserve(Name *table, int capacity)                                                 \
+    {                                                                                              \
+        assert(table && capacity > -1);                                                            \
+        if (capacity <= table->capacity)                                                           \
+        {                                                                                          \
+            return;                                                                                \
+        }                                                                                          \
+        Type *new_tab = (Type *)realloc(table->tab, capacity * sizeof(Type));                      \
+        verify(new_tab != NULL, "realloc error");                                                  \
+        table->tab = new_tab;                                                                      \
+        table->capacity = capacity;                                                                \
+    }                                                                                              \
+                                                                                                   \
+    void Name##_push_n(Type const *values, int n, Name *table)                                     \
+    {                                                                                              \
+        assert(table && n > -1 && (values || n == 0));                                             \
+        if (table->size + n > table->capacity)                                                     \
+        {                                                                                          \
+            int capacity = DYN_TABLE_GROWTH(table->capacity);                                      \
+            Name##_reserve(table, capacity > table->size + n ? capacity : table->size + n);        \
+        }                                                                                          \
+        if (n > 0)                                                                                 \
+        {                                                                                          \
+            memcpy(table->tab + table->size, values, n * sizeof(Type));                            \
+        }                                                                                          \
+        table->size += n;                                                                          \
+    }                                                                                              \
+                                                                                                   \
+    void Name##_shrink_to_fit(Name *table)                                                         \
+    {                                                                                              \
+        assert(table);                                                                             \
+        if (table->size == table->capacity)                                                        \
+        {                                                                                          \
+            return;                                                                                \
+        }                                                                                          \
+        if (table->size == 0)                                                                      \
+        {                                                                                          \
+            free(table->tab);                                                                      \
+            table->tab = NULL;                                                                     \
+            table->capacity = 0;                                                                   \
+            return;                                                                                \
+        }                                                                                          \
+        Type *new_tab = (Type *)realloc(table->tab, table->size * sizeof(Type));                   \
+        verify(new_tab != NULL, "realloc error");                                                  \
+        table->tab = new_tab;                                                                      \
+        table->capacity = table->size;                                                             \
+    }                                                                                              \
+                                                                                                   \
+    void Name##_free(Name *tab, void (*free_elem)(Type))                                           \
+    {                                                                                              \
+        if (tab == NULL)                                                                           \
+        {                                                                                          \
+            fprintf(stderr, BOLD_RED "WARNING : dynamic table struct %s is NULL\n" RESET, #Name);  \
+            return;                                                                                \
+        }                                                                                          \
+        if (free_elem != NULL)                                                                     \
+        {                                                                                          \
+            for (int i = 0; i < tab->size; i++)                                                    \
+            {                                                                                      \
+                free_elem(tab->tab[i]);                                                            \
+            }                                                                                      \
+        }                                                                                          \
+        free(tab->tab);                                                                            \
+        tab->tab = NULL;                                                                           \
+        free(tab);                                                                                 \
+    }                                                                                              \
+                                                                                                   \
+    Name *Name##_load_from_bin(FILE *file, Type (*load_elem)(FILE *))                              \
+    {                                                                                              \
+        assert(file);                                                                              \
+        Name *dtab = Name##_init();                                                                \
+        assert(dtab);                                                                              \
+        verify(fread(&(dtab->capacity), sizeof(int), 1, file) == 1,                                \
+               "couldn't load dynamic table capacity (int) while loading from binary");            \
+        verify(fread(&(dtab->size), sizeof(int), 1, file) == 1,                                    \
+               "couldn't load dynamic table size (int) while loading from binary");                \
+                                                                                                   \
+        dtab->tab = (Type *)malloc(dtab->capacity * sizeof(Type));                                 \
+        assert(dtab->tab);                                                                         \
+        if (load_elem == NULL)                                                                     \
+        {                                                                                          \
+            /*We assume that if load_elem is NULL, the table does not contain any pointer*/        \
+            if (fread(dtab->tab, sizeof(Type), dtab->size, file) != (size_t)dtab->size)            \
+            {                                                                                      \
+                printf("couldn't load dynamic table content while loading from binary");           \
+                perror("fread\n");                                                                 \
+                printf("feof : %d\n", feof(file));                                                 \
+                exit(1);                                                                           \
+            }                                                                                      \
+        }                                                                                          \
+        else                                                                                       \
+        {                                                                                          \
+            /*Otherwise, we need to do the load of the table manually*/                            \
+            for (int i = 0; i < dtab->size; i++)                                                   \
+            {                                                                                      \
+                dtab->tab[i] = load_elem(file);                                                    \
+            }                                                                                      \
+        }                                                                                          \
+        return dtab;                                                                               \
+    }
+
+#ifndef INLINE_SORT_THRESHOLD
+/// @brief Parts of at most this number of elements are sorted by insertion (see
+/// DEFINE_INLINE_SORT)
+#define INLINE_SORT_THRESHOLD 16
+#endif
+
+/// DEFINE_INLINE_SORT generates a sort function specialised for an element type and an order :
+/// an introsort (median of three quicksort, heapsort when the recursion gets too deep, insertion
+/// sort of the small parts). Unlike qsort, comparisons are expanded in place and can be inlined.
+/// The sort is not stable : make LESS a total order (e.g. break ties on the position) if the order
+/// of equal elements matters.\n
+/// A partial sort is generated too : static void Name_partial(Type *tab, int n, int k) puts the k
+/// smallest elements in order at the front of tab (the rest in any order), in O(n + k log k). It
+/// selects them with an introselect (quickselect, heap selection when it gets too deep).
+/// @param Type the type of the elements
+/// @param Name the name of the generated function : static void Name(Type *tab, int n)
+/// @param LESS function or macro taking two elements (by value), true if the first one must be
+/// placed before the second one (strict weak order)
+#define DEFINE_INLINE_SORT(Type, Name, LESS)                                                       \
+    static inline void Name##_swap(Type *a, Type *b)                                               \
+    {                                                                                              \
+        Type tmp = *a;                                                                             \
+        *a = *b;                                                                                   \
+        *b = tmp;                                                                                  \
+    }                                                                                              \
+    static inline void Name##_insertion(Type *tab, int n)                                          \
+    {                                                                                              \
+        for (int i = 1; i < n; i++)                                                                \
+        {                                                                                          \
+            Type value = tab[i];                                                                   \
+            int j = i - 1;                                                                         \
+            while (j > -1 && LESS(value, tab[j]))                                                  \
+            {                                                                                      \
+                tab[j + 1] = tab[j];                                                               \
+                j--;                                                                               \
+            }                                                                                      \
+            tab[j + 1] = value;                                                                    \
+        }                                                                                          \
+    }                                                                                              \
+    static inline void Name##_sift_down(Type *tab, int root, int n)                                \
+    {                                                                                              \
+        Type value = tab[root];                                                                    \
+        int child = 2 * root + 1;                                                                  \
+        while (child < n)                                                                          \
+        {                                                                                          \
+            if (child + 1 < n && LESS(tab[child], tab[child + 1]))                                 \
+            {                                                                                      \
+                child++;                                                                           \
+            }                                                                                      \
+            if (!LESS(value, tab[child]))                                                          \
+            {                                                                                      \
+                break;                                                                             \
+            }                                                                                      \
+            tab[root] = tab[child];                                                                \
+            root = child;                                                                          \
+            child = 2 * root + 1;                                                                  \
+        }                                                                                          \
+        tab[root] = value;                                                                         \
+    }                                                                                              \
+    static inline void Name##_heapsort(Type *tab, int n)                                           \
+    {                                                                                              \
+        for (int i = n / 2 - 1; i > -1; i--)                                                       \
+        {                                                                                          \
+            Name##_sift_down(tab, i, n);                                                           \
+        }                                                                                          \
+        for (int i = n - 1; i > 0; i--)                                                            \
+        {                                                                                          \
+            Name##_swap(&tab[0], &tab[i]);                                                         \
+            Name##_sift_down(tab, 0, i);                                                           \
+        }                                                                                          \
+    }                                                                                              \
+    /* median of three, then Hoare partition around it : returns the size of the left part */      \
+    static inline int Name##_partition(Type *tab, int n)                                           \
+    {                                                                                              \
+        int mid = (n - 1) / 2;                                                                     \
+        if (LESS(tab[mid], tab[0]))                                                                \
+        {                                                                                          \
+            Name##_swap(&tab[mid], &tab[0]);                                                       \
+        }                                                                                          \
+        if (LESS(tab[n - 1], tab[mid]))                                                            \
+        {                                                                                          \
+            Name##_swap(&tab[n - 1], &tab[mid]);                                                   \
+            if (LESS(tab[mid], tab[0]))                                                            \
+            {                                                                                      \
+                Name##_swap(&tab[mid], &tab[0]);                                                   \
+            }                                                                                      \
+        }                                                                                          \
+        Type pivot = tab[mid];                                                                     \
+        int i = -1;                                                                                \
+        int j = n;                                                                                 \
+        for (;;)                                                                                   \
+        {                                                                                          \
+            do                                                                                     \
+            {                                                                                      \
+                i++;                                                                               \
+            } while (LESS(tab[i], pivot));                                                         \
+            do                                                                                     \
+            {                                                                                      \
+                j--;                                                                               \
+            } while (LESS(pivot, tab[j]));                                                         \
+            if (i >= j)                                                                            \
+            {                                                                                      \
+                return j + 1;                                                                      \
+            }                                                                                      \
+            Name##_swap(&tab[i], &tab[j]);                                                         \
+        }                                                                                          \
+    }                                                                                              \
+    static inline void Name##_introsort(Type *tab, int n, int depth)                               \
+    {                                                                                              \
+        while (n > INLINE_SORT_THRESHOLD)                                                          \
+        {                                                                                          \
+            if (depth == 0) /* quicksort degenerates : finish with a heapsort */                   \
+            {                                                                                      \
+                Name##_heapsort(tab, n);                                                           \
+                return;                                                                            \
+            }                                                                                      \
+            depth--;                                                                               \
+            /* recurse on the smaller part, loop on the bigger one */                              \
+            int n_left = Name##_partition(tab, n);                                                 \
+            if (n_left < n - n_left)                                                               \
+            {                                                                                      \
+                Name##_introsort(tab, n_left, depth);                                              \
+                tab += n_left;                                                                     \
+                n -= n_left;                                                                       \
+            }                                                                                      \
+            else                                                                                   \
+            {                                                                                      \
+                Name##_introsort(tab + n_left, n - n_left, depth);                                 \
+                n = n_left;                                                                        \
+            }                                                                                      \
+        }                                                                                          \
+        Name##_insertion(tab, n);                                                                  \
+    }                                                                                              \
+    static inline int Name##_max_depth(int n)                                                      \
+    {                                                                                              \
+        int depth = 0;                                                                             \
+        for (int m = n; m > 1; m /= 2)                                                             \
+        {                                                                                          \
+            depth += 2;                                                                            \
+        }                                                                                          \
+        return depth;                                                                              \
+    }                                                                                              \
+    static inline void Name(Type *tab, int n)                                                      \
+    {                                                                                              \
+        assert(tab || n == 0);                                                                     \
+        Name##_introsort(tab, n, Name##_max_depth(n));                                             \
+    }                                                                                              \
+    /* move the k smallest elements to the front with a max heap of k elements (any order) */      \
+    static inline void Name##_heap_select(Type *tab, int n, int k)                                 \
+    {                                                                                              \
+        for (int i = k / 2 - 1; i > -1; i--)                                                       \
+        {                                                                                          \
+            Name##_sift_down(tab, i, k);                                                           \
+        }                                                                                          \
+        for (int i = k; i < n; i++)                                                                \
+        {                                                                                          \
+            if (LESS(tab[i], tab[0]))                                                              \
+            {                                                                                      \
+                Name##_swap(&tab[0], &tab[i]);                                                     \
+                Name##_sift_down(tab, 0, k);                                                       \
+            }                                                                                      \
+        }                                                                                          \
+    }                                                                                              \
+    static inline void Name##_partial(Type *tab, int n, int k)                                     \
+    {                                                                                              \
+        assert((tab || n == 0) && k > -1);                                                         \
+        k = k < n ? k : n;                                                                         \
+        int depth = Name##_max_depth(n);                                                           \
+        /* introselect : only the part holding the k-th element is partitioned again */            \
+        Type *part = tab;                                                                          \
+        int m = n;                                                                                 \
+        int k_left = k;                                                                            \
+        while (k_left > 0 && m > INLINE_SORT_THRESHOLD)                                            \
+        {                                                                                          \
+            if (depth == 0) /* quickselect degenerates : finish with a heap selection */           \
+            {                                                                                      \
+                Name##_heap_select(part, m, k_left);                                               \
+                k_left = 0;                                                                        \
+            }                                                                                      \
+            depth--;                                                                               \
+            int n_left = Name##_partition(part, m);                                                \
+            if (k_left < n_left)                                                                   \
+            {                                                                                      \
+                m = n_left;                                                                        \
+            }                                                                                      \
+            else /* the whole left part is among the k smallest */                                 \
+            {                                                                                      \
+                part += n_left;                                                                    \
+                m -= n_left;                                                                       \
+                k_left -= n_left;                                                                  \
+            }                                                                                      \
+        }                                                                                          \
+        if (k_left > 0)                                                                            \
+        {                                                                                          \
+            Name##_insertion(part, m);                                                             \
+        }                                                                                          \
+        Name##_introsort(tab, k, Name##_max_depth(k));                                             \
+    }
+
+/// DEFINE_DYN_TABLE_SORT generates a specialised sort of a dynamic table (see DEFINE_INLINE_SORT).
+/// Usage example:
+/// DEFINE_DYN_TABLE_SORT(Student *, StudentsTab, by_id, STUDENT_ID_LESS) generates
+/// static void StudentsTab_sort_by_id(StudentsTab *table) (and StudentsTab_sort_by_id_tab, sorting
+/// a plain array)
+/// @param Type the type of the elements stored in the dynamic table
+/// @param Name the name of the dynamic table structure
+/// @param Suffix the suffix of the generated function
+/// @param LESS function or macro taking two elements (by value), true if the first one must be
+/// placed before the second one
+#define DEFINE_DYN_TABLE_SORT(Type, Name, Suffix, LESS)                                            \
+    DEFINE_INLINE_SORT(Type, Name##_sort_##Suffix##_tab, LESS)                                     \
+    static inline void Name##_sort_##Suffix(Name *table)                                           \
+    {                                                                                              \
+        assert(table);                                                                             \
+        Name##_sort_##Suffix##_tab(table->tab, table->size);                                       \
+    }
+
 #endif
\ No newline at end of file
@@ -0,0 +1,220 @@
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "simd_avg.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__) &&                             \
+        !defined(SIMD_AVG_FORCE_SCALAR)
+#define SIMD_AVG_X86
+#include <immintrin.h>
+#endif
+
+/// @brief Weighted sums of the rows [begin, end[, one row at a time
+static void weighted_sums_rows(const float *values, int n_cols, int begin, int end,
+                               const float *coefs, float min, float max, float *weighted_sums,
+                               float *coef_sums)
+{
+    for (int i = begin; i < end; i++)
+    {
+        const float *row = values + (long)i * n_cols;
+        float total = 0;
+        float total_coef = 0;
+        for (int j = 0; j < n_cols; j++)
+        {
+            if (row[j] > min && row[j] < max)
+            {
+                float product = row[j] * coefs[j]; // rounded before the sum, as in the kernels
+                total += product;
+                total_coef += coefs[j];
+            }
+        }
+        weighted_sums[i] = total;
+        coef_sums[i] = total_coef;
+    }
+}
+
+static void weighted_sums_scalar(const float *values, int n_cols, int n_rows, const float *coefs,
+                                 float min, float max, float *weighted_sums, float *coef_sums)
+{
+    weighted_sums_rows(values, n_cols, 0, n_rows, coefs, min, max, weighted_sums, coef_sums);
+}
+
+#ifdef SIMD_AVG_X86
+/// @brief Number of rows summed at once by the SSE2 kernel
+#define SSE2_ROWS 4
+/// @brief Number of rows summed at once by the AVX2 kernel
+#define AVX2_ROWS 8
+
+static void weighted_sums_sse2(const float *values, int n_cols, int n_rows, const float *coefs,
+                               float min, float max, float *weighted_sums, float *coef_sums)
+{
+    const __m128 vmin = _mm_set1_ps(min);
+    const __m128 vmax = _mm_set1_ps(max);
+    int i = 0;
+    for (; i + SSE2_ROWS <= n_rows; i += SSE2_ROWS)
+    {
+        const float *row = values + (long)i * n_cols;
+        __m128 sums = _mm_setzero_ps();
+        __m128 sums_coef = _mm_setzero_ps();
+        for (int j = 0; j < n_cols; j++)
+        {
+            // column j of the 4 rows (no gather in SSE2)
+            __m128 vals = _mm_set_ps(row[3 * n_cols + j], row[2 * n_cols + j], row[n_cols + j],
+                                     row[j]);
+            __m128 coef = _mm_set1_ps(coefs[j]);
+            __m128 in_range = _mm_and_ps(_mm_cmpgt_ps(vals, vmin), _mm_cmplt_ps(vals, vmax));
+            sums = _mm_add_ps(sums, _mm_and_ps(_mm_mul_ps(vals, coef), in_range));
+            sums_coef = _mm_add_ps(sums_coef, _mm_and_ps(coef, in_range));
+        }
+        _mm_storeu_ps(weighted_sums + i, sums);
+        _mm_storeu_ps(coef_sums + i, sums_coef);
+    }
+    weighted_sums_rows(values, n_cols, i, n_rows, coefs, min, max, weighted_sums, coef_sums);
+}
+
+__attribute__((target("avx2"))) static void weighted_sums_avx2(const float *values, int n_cols,
+                                                               int n_rows, const float *coefs,
+                                                               float min, float max,
+                                                               float *weighted_sums,
+                                                               float *coef_sums)
+{
+    const __m256 vmin = _mm256_set1_ps(min);
+    const __m256 vmax = _mm256_set1_ps(max);
+    // offset of each row from the first one of a block
+    const __m256i row_offsets = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7),
+                                                   _mm256_set1_epi32(n_cols));
+    int i = 0;
+    for (; i + AVX2_ROWS <= n_rows; i += AVX2_ROWS)
+    {
+        const float *row = values + (long)i * n_cols;
+        __m256 sums = _mm256_setzero_ps();
+        __m256 sums_coef = _mm256_setzero_ps();
+        for (int j = 0; j < n_cols; j++)
+        {
+            __m256 vals = _mm256_i32gather_ps(row + j, row_offsets, sizeof(float));
+            __m256 coef = _mm256_set1_ps(coefs[j]);
+            __m256 in_range = _mm256_and_ps(_mm256_cmp_ps(vals, vmin, _CMP_GT_OQ),
+                                            _mm256_cmp_ps(vals, vmax, _CMP_LT_OQ));
+            // mul then add (no fma) : rounded as the scalar loop
+            sums = _mm256_add_ps(sums, _mm256_and_ps(_mm256_mul_ps(vals, coef), in_range));
+            sums_coef = _mm256_add_ps(sums_coef, _mm256_and_ps(coef, in_range));
+        }
+        _mm256_storeu_ps(weighted_sums + i, sums);
+        _mm256_storeu_ps(coef_sums + i, sums_coef);
+    }
+    weighted_sums_rows(values, n_cols, i, n_rows, coefs, min, max, weighted_sums, coef_sums);
+}
+#endif
+
+/// @brief Weighted sums kernel selected for the running CPU
+static void (*weighted_sums_kernel)(const float *, int, int, const float *, float, float, float *,
+                                    float *) = weighted_sums_scalar;
+/// @brief Name of the selected kernel
+static const char *avg_kernel_isa = "scalar";
+
+/// @brief Get the float just below a (non NaN) float
+static float float_next_down(float f)
+{
+    if (f == 0)
+    {
+        f = -0.0f; // the next float down is the smallest negative denormal
+    }
+    uint32_t bits;
+    memcpy(&bits, &f, sizeof(bits));
+    bits = f > 0 ? bits - 1 : bits + 1;
+    memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+/// @brief Round a double bound down to a float : for any float v, v > x iff v > float_below(x)
+static float float_below(double x)
+{
+    float f = (float)x;
+    return f > x ? float_next_down(f) : f;
+}
+
+/// @brief Round a double bound up to a float : for any float v, v < x iff v < float_above(x)
+static float float_above(double x)
+{
+    float f = (float)x;
+    return f < x ? -float_next_down(-f) : f;
+}
+
+void weighted_sums_in_range(const float *values, int n_cols, int n_rows, const float *coefs,
+                            double min, double max, float *weighted_sums, float *coef_sums)
+{
+    assert(n_cols > -1 && n_rows > -1);
+    assert((weighted_sums && coef_sums) || n_rows == 0);
+    assert((values && coefs) || n_rows == 0 || n_cols == 0);
+    // the kernels compare in float : same result as comparing the values to the double bounds
+    weighted_sums_kernel(values, n_cols, n_rows, coefs, float_below(min), float_above(max),
+                         weighted_sums, coef_sums);
+}
+
+#ifndef NDEBUG
+/// @brief Check the selected kernel against the loop of get_student_general_avg (bounds compared
+/// as doubles) on the float neighbours of the grade bounds, whose float roundings are on both
+/// sides of the double bounds. Rows go through the vector blocks and the scalar tail.
+static void check_avg_kernel_at_bounds(void)
+{
+    const double min = -0.0001;
+    const double max = 20.0001;
+    const float edges[] = {
+            (float)min, float_next_down((float)min), -float_next_down(-(float)min), -1.0f,
+            (float)max, float_next_down((float)max), -float_next_down(-(float)max), 10.0f};
+    enum
+    {
+        N_EDGES = sizeof(edges) / sizeof(edges[0]),
+        N_COLS = 3,
+        N_ROWS = 2 * N_EDGES + 3
+    };
+    const float coefs[N_COLS] = {1.0f, 2.0f, 0.5f};
+    float values[N_ROWS * N_COLS];
+    for (int i = 0; i < N_ROWS * N_COLS; i++)
+    {
+        values[i] = edges[(i + i / N_EDGES) % N_EDGES];
+    }
+    float weighted_sums[N_ROWS];
+    float coef_sums[N_ROWS];
+    weighted_sums_in_range(values, N_COLS, N_ROWS, coefs, min, max, weighted_sums, coef_sums);
+    for (int i = 0; i < N_ROWS; i++)
+    {
+        float total = 0;
+        float total_coef = 0;
+        for (int j = 0; j < N_COLS; j++)
+        {
+            float avg = values[i * N_COLS + j];
+            if (avg > min && avg < max)
+            {
+                total += avg * coefs[j];
+                total_coef += coefs[j];
+            }
+        }
+        assert(weighted_sums[i] == total && coef_sums[i] == total_coef);
+    }
+}
+#endif
+
+/// @brief Select the best kernel once, before main (and before any thread is started)
+__attribute__((constructor)) static void select_avg_kernel(void)
+{
+#ifdef SIMD_AVG_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+    {
+        weighted_sums_kernel = weighted_sums_avx2;
+        avg_kernel_isa = "avx2";
+    }
+    else
+    {
+        weighted_sums_kernel = weighted_sums_sse2; // always available on x86-64
+        avg_kernel_isa = "sse2";
+    }
+#endif
+#ifndef NDEBUG
+    check_avg_kernel_at_bounds();
+#endif
+}
+
+const char *simd_avg_isa(void) { return avg_kernel_isa; }
@@ -0,0 +1,30 @@
+#ifndef SIMD_AVG_H
+#define SIMD_AVG_H
+
+/// @file simd_avg.h
+/// @brief Vectorized kernel of the averages evaluation : the masked, coefficient weighted sum of
+/// the course averages of a block of students. The students are processed 4 (SSE2) or 8 (AVX2) at
+/// a time, one per lane : the averages of each student are still added in course order, so every
+/// kernel gives the same sums, bit for bit, as the scalar loop of get_student_general_avg.\n
+/// As in simd_scan.h, the best kernel available on the running CPU is selected at startup, a
+/// scalar kernel is used on other architectures or when SIMD_AVG_FORCE_SCALAR is defined.
+
+/// @brief Sum, for each row of a row-major table, the values in the range ]min, max[ weighted by
+/// the coef of their column, and these coefs
+/// @param values the table (n_rows rows of n_cols values, e.g. the course averages of students)
+/// @param n_cols the number of columns
+/// @param n_rows the number of rows
+/// @param coefs the coef of each column
+/// @param min values at most min are ignored (compared as doubles, as get_student_general_avg
+/// compares the averages to GRADE_MIN)
+/// @param max values at least max are ignored (compared as doubles)
+/// @param weighted_sums receives the sum of value * coef over the values in range of each row
+/// @param coef_sums receives the sum of the coefs of the values in range of each row
+void weighted_sums_in_range(const float *values, int n_cols, int n_rows, const float *coefs,
+                            double min, double max, float *weighted_sums, float *coef_sums);
+
+/// @brief Get the name of the instruction set used by weighted_sums_in_range
+/// @return "avx2", "sse2" or "scalar"
+const char *simd_avg_isa(void);
+
+#endif
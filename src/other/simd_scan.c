@@ -0,0 +1,135 @@
+#include <assert.h>
+#include <stdbool.h>
+
+#include "simd_scan.h"
+#include "utils.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__) &&                             \
+        !defined(SIMD_SCAN_FORCE_SCALAR)
+#define SIMD_SCAN_X86
+#include <immintrin.h>
+#endif
+
+/// @brief State of a line scan, shared by every kernel
+typedef struct line_scan
+{
+    const char **field_ends; //!< Output table of field ends
+    int max_fields;          //!< Size of field_ends
+    int n_fields;            //!< Number of fields found so far
+    const char *eol;         //!< End of line, once found
+} Line_scan;
+
+/// @brief Record the separators and newline found in a block, given their position bitmasks
+/// @return true if the end of line was found in this block
+static inline bool record_block(Line_scan *scan, const char *base, unsigned int sep_mask,
+                                unsigned int nl_mask)
+{
+    if (nl_mask)
+    {
+        unsigned int nl_pos = __builtin_ctz(nl_mask);
+        sep_mask &= (1u << nl_pos) - 1; // ignore the separators of the next lines
+        scan->eol = base + nl_pos;
+    }
+    while (sep_mask && scan->n_fields < scan->max_fields - 1)
+    {
+        scan->field_ends[scan->n_fields++] = base + __builtin_ctz(sep_mask);
+        sep_mask &= sep_mask - 1; // clear lowest set bit
+    }
+    return nl_mask != 0;
+}
+
+/// @brief Scalar kernel, also used for the tails too short for a vector load
+static inline void scan_tail(Line_scan *scan, const char *p, const char *end)
+{
+    for (; p < end; p++)
+    {
+        if (*p == '\n')
+        {
+            scan->eol = p;
+            return;
+        }
+        if (*p == CSV_SEP && scan->n_fields < scan->max_fields - 1)
+        {
+            scan->field_ends[scan->n_fields++] = p;
+        }
+    }
+    scan->eol = end;
+}
+
+static void scan_scalar(Line_scan *scan, const char *p, const char *end)
+{
+    scan_tail(scan, p, end);
+}
+
+#ifdef SIMD_SCAN_X86
+static void scan_sse2(Line_scan *scan, const char *p, const char *end)
+{
+    const __m128i sep = _mm_set1_epi8(CSV_SEP);
+    const __m128i nl = _mm_set1_epi8('\n');
+    for (; end - p >= 16; p += 16)
+    {
+        __m128i block = _mm_loadu_si128((const __m128i *)p);
+        unsigned int sep_mask = _mm_movemask_epi8(_mm_cmpeq_epi8(block, sep));
+        unsigned int nl_mask = _mm_movemask_epi8(_mm_cmpeq_epi8(block, nl));
+        if (record_block(scan, p, sep_mask, nl_mask))
+        {
+            return;
+        }
+    }
+    scan_tail(scan, p, end);
+}
+
+__attribute__((target("avx2"))) static void scan_avx2(Line_scan *scan, const char *p,
+                                                      const char *end)
+{
+    const __m256i sep = _mm256_set1_epi8(CSV_SEP);
+    const __m256i nl = _mm256_set1_epi8('\n');
+    for (; end - p >= 32; p += 32)
+    {
+        __m256i block = _mm256_loadu_si256((const __m256i *)p);
+        unsigned int sep_mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(block, sep));
+        unsigned int nl_mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(block, nl));
+        if (record_block(scan, p, sep_mask, nl_mask))
+        {
+            return;
+        }
+    }
+    scan_sse2(scan, p, end); // less than 32 bytes left
+}
+#endif
+
+/// @brief Kernel selected for the running CPU
+static void (*scan_kernel)(Line_scan *, const char *, const char *) = scan_scalar;
+/// @brief Name of the selected kernel
+static const char *scan_kernel_isa = "scalar";
+
+/// @brief Select the best kernel once, before main (and before any thread is started)
+__attribute__((constructor)) static void select_scan_kernel(void)
+{
+#ifdef SIMD_SCAN_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+    {
+        scan_kernel = scan_avx2;
+        scan_kernel_isa = "avx2";
+    }
+    else
+    {
+        scan_kernel = scan_sse2; // always available on x86-64
+        scan_kernel_isa = "sse2";
+    }
+#endif
+}
+
+int scan_line_fields(const char *p, const char *end, const char *field_ends[], int max_fields,
+                     const char **eol)
+{
+    assert(p && p <= end && field_ends && max_fields > 0 && eol);
+    Line_scan scan = {.field_ends = field_ends, .max_fields = max_fields, .n_fields = 0};
+    scan_kernel(&scan, p, end);
+    field_ends[scan.n_fields++] = scan.eol; // end of the last field
+    *eol = scan.eol;
+    return scan.n_fields;
+}
+
+const char *simd_scan_isa(void) { return scan_kernel_isa; }
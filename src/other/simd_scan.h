@@ -0,0 +1,29 @@
+#ifndef SIMD_SCAN_H
+#define SIMD_SCAN_H
+
+/// @file simd_scan.h
+/// @brief Vectorized scanning of CSV_SEP separated lines (as used in the data file).
+/// Separators and newlines are searched 16 (SSE2) or 32 (AVX2) bytes at a time, the best kernel
+/// available on the running CPU being selected at startup. A scalar kernel is used on other
+/// architectures or when SIMD_SCAN_FORCE_SCALAR is defined.
+
+#include <stddef.h>
+
+/// @brief Find the fields of the line starting at p.
+/// The end of each field (position of its CSV_SEP, or end of line for the last one) is stored in
+/// field_ends. Once max_fields - 1 separators are found, the remaining ones are part of the last
+/// field.
+/// @param p first byte of the line
+/// @param end end of the readable buffer (nothing is read at or after end)
+/// @param field_ends output table (of max_fields elements) receiving the end of each field
+/// @param max_fields the maximum number of fields to find (> 0)
+/// @param eol receives the end of the line (position of its '\n', or end if there is none)
+/// @return the number of fields found (between 1 and max_fields)
+int scan_line_fields(const char *p, const char *end, const char *field_ends[], int max_fields,
+                     const char **eol);
+
+/// @brief Get the name of the instruction set used by scan_line_fields
+/// @return "avx2", "sse2" or "scalar"
+const char *simd_scan_isa(void);
+
+#endif
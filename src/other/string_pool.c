@@ -0,0 +1,92 @@
+#include <assert.h>
+#include <string.h>
+
+#include "string_pool.h"
+#include "utils.h"
+
+/// @brief Allocate the slots of a pool (all empty)
+static void alloc_slots(String_pool *pool, int n_slots)
+{
+    pool->n_slots = n_slots;
+    pool->slots = (const char **)calloc(n_slots, sizeof(const char *));
+    pool->hashes = (unsigned int *)malloc(n_slots * sizeof(unsigned int));
+    verify(pool->slots && pool->hashes, "malloc error");
+}
+
+String_pool *init_string_pool(Arena *arena, int expected_size)
+{
+    assert(arena && expected_size > -1);
+    String_pool *pool = (String_pool *)malloc(sizeof(String_pool));
+    verify(pool, "malloc error");
+    int n_slots = STRING_POOL_MIN_SLOTS;
+    while (n_slots < 2 * expected_size)
+    {
+        n_slots *= 2;
+    }
+    alloc_slots(pool, n_slots);
+    pool->size = 0;
+    pool->arena = arena;
+    return pool;
+}
+
+void free_string_pool(String_pool *pool)
+{
+    assert(pool);
+    free(pool->slots);
+    free(pool->hashes);
+    free(pool);
+}
+
+/// @brief Double the number of slots of a pool and insert back its strings
+static void string_pool_grow(String_pool *pool)
+{
+    const char **old_slots = pool->slots;
+    unsigned int *old_hashes = pool->hashes;
+    int old_n_slots = pool->n_slots;
+    alloc_slots(pool, old_n_slots * 2);
+    int mask = pool->n_slots - 1;
+    for (int j = 0; j < old_n_slots; j++)
+    {
+        if (!old_slots[j])
+        {
+            continue;
+        }
+        int i = old_hashes[j] & mask;
+        while (pool->slots[i])
+        {
+            i = (i + 1) & mask;
+        }
+        pool->slots[i] = old_slots[j];
+        pool->hashes[i] = old_hashes[j];
+    }
+    free(old_slots);
+    free(old_hashes);
+}
+
+const char *string_pool_intern(String_pool *pool, const char *str, size_t len)
+{
+    assert(pool && str);
+    if (2 * (pool->size + 1) > pool->n_slots)
+    {
+        string_pool_grow(pool);
+    }
+    unsigned int hash = hash_string(str, len);
+    int mask = pool->n_slots - 1;
+    int i = hash & mask;
+    for (; pool->slots[i]; i = (i + 1) & mask)
+    {
+        const char *slot = pool->slots[i];
+        // strncmp stops at the end of the interned string, which may be shorter than len
+        if (pool->hashes[i] == hash && strncmp(slot, str, len) == 0 && slot[len] == '\0')
+        {
+            return slot;
+        }
+    }
+    char *copy = (char *)arena_alloc(pool->arena, len + 1);
+    memcpy(copy, str, len);
+    copy[len] = '\0';
+    pool->slots[i] = copy;
+    pool->hashes[i] = hash;
+    pool->size++;
+    return copy;
+}
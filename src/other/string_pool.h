@@ -0,0 +1,52 @@
+#ifndef STRING_POOL_H
+#define STRING_POOL_H
+
+/// @file string_pool.h
+/// @brief String interning pool : every distinct string is stored once (in an arena), and the
+/// pool hands out the same pointer for equal strings. Student names and first names repeat a lot
+/// in a promotion, so interning them saves one copy per student, and two interned names are equal
+/// if and only if their pointers are.
+
+#include <stddef.h>
+
+#include "arena.h"
+
+#ifndef STRING_POOL_MIN_SLOTS
+/// @brief Minimum number of slots of a string pool (power of two)
+#define STRING_POOL_MIN_SLOTS 64
+#endif
+
+/// @brief Open addressing hash set (linear probing) of strings allocated in an arena
+typedef struct string_pool
+{
+    ///@brief string stored in each slot, NULL if the slot is empty
+    const char **slots;
+    ///@brief hash of the string of each slot
+    unsigned int *hashes;
+    ///@brief number of slots (power of two), always at least twice the number of strings
+    int n_slots;
+    ///@brief number of interned strings
+    int size;
+    ///@brief arena the strings are allocated in (not owned by the pool)
+    Arena *arena;
+} String_pool;
+
+/// @brief Create an empty string pool
+/// @param arena the arena the strings are allocated in, must outlive the interned strings
+/// @param expected_size expected number of distinct strings (0 if unknown), the pool grows as
+/// needed
+/// @return the allocated pool
+String_pool *init_string_pool(Arena *arena, int expected_size);
+
+/// @brief Free a string pool. The interned strings are not freed (they belong to the arena).
+/// @param pool the pool to free
+void free_string_pool(String_pool *pool);
+
+/// @brief Get the interned copy of a string, adding it to the pool if needed
+/// @param pool the pool
+/// @param str the string (does not need to be null terminated, must not contain '\0')
+/// @param len the length of the string
+/// @return the interned string (null terminated), the same pointer for every equal string
+const char *string_pool_intern(String_pool *pool, const char *str, size_t len);
+
+#endif
@@ -0,0 +1,31 @@
+#include <assert.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "threads.h"
+#include "utils.h"
+
+int get_n_threads(int n_threads)
+{
+    if (n_threads <= 0)
+    {
+        long n_cpu = sysconf(_SC_NPROCESSORS_ONLN);
+        n_threads = n_cpu > 0 ? (int)n_cpu : 1;
+    }
+    return n_threads < MAX_THREADS ? n_threads : MAX_THREADS;
+}
+
+void run_threads(void *(*worker)(void *), void *args, size_t arg_size, int n_threads)
+{
+    pthread_t threads[MAX_THREADS];
+    assert(worker && args && n_threads > 0 && n_threads <= MAX_THREADS);
+    for (int i = 0; i < n_threads; i++)
+    {
+        verify(pthread_create(&threads[i], NULL, worker, (char *)args + i * arg_size) == 0,
+               "pthread_create failed");
+    }
+    for (int i = 0; i < n_threads; i++)
+    {
+        verify(pthread_join(threads[i], NULL) == 0, "pthread_join failed");
+    }
+}
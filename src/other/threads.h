@@ -0,0 +1,28 @@
+#ifndef THREADS_H
+#define THREADS_H
+
+/// @file threads.h
+/// @brief Fork-join helpers shared by the multithreaded passes (grades loading, averages
+/// evaluation) : a pass splits its work in one argument per thread and runs them all at once.
+
+#include <stddef.h>
+
+#ifndef MAX_THREADS
+/// @brief Maximum number of threads run by run_threads
+#define MAX_THREADS 64
+#endif
+
+/// @brief Get the number of threads to use for a pass
+/// @param n_threads the wished number of threads, 0 (or less) to use every online CPU
+/// @return the number of threads, between 1 and MAX_THREADS
+int get_n_threads(int n_threads);
+
+/// @brief Run n_threads threads on worker and wait for all of them, thread i receiving the i-th
+/// element of args (exit on error)
+/// @param worker the function run by every thread
+/// @param args table of n_threads arguments
+/// @param arg_size size of an argument in bytes
+/// @param n_threads number of threads, between 1 and MAX_THREADS
+void run_threads(void *(*worker)(void *), void *args, size_t arg_size, int n_threads);
+
+#endif
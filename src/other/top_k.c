@@ -0,0 +1,61 @@
+#include <stdlib.h>
+
+#include "top_k.h"
+#include "utils.h"
+
+Top_k *init_top_k(int k)
+{
+    assert(k > -1);
+    Top_k *top = (Top_k *)malloc(sizeof(Top_k));
+    verify(top, "malloc error");
+    top->heap = (Top_k_entry *)malloc((k > 0 ? k : 1) * sizeof(Top_k_entry));
+    verify(top->heap, "malloc error");
+    top->size = 0;
+    top->k = k;
+    return top;
+}
+
+void free_top_k(Top_k *top)
+{
+    assert(top);
+    free(top->heap);
+    free(top);
+}
+
+void top_k_sift_down(Top_k_entry *heap, int size)
+{
+    Top_k_entry entry = heap[0];
+    int i = 0;
+    int child = 1;
+    while (child < size)
+    {
+        if (child + 1 < size && top_k_entry_is_worse(heap[child + 1], heap[child]))
+        {
+            child++;
+        }
+        if (!top_k_entry_is_worse(heap[child], entry))
+        {
+            break;
+        }
+        heap[i] = heap[child];
+        i = child;
+        child = 2 * i + 1;
+    }
+    heap[i] = entry;
+}
+
+int top_k_sort(Top_k *top)
+{
+    assert(top);
+    int n = top->size;
+    // the worst entry is moved behind the heap until it is empty : the best one ends up first
+    for (int size = n - 1; size > 0; size--)
+    {
+        Top_k_entry worst = top->heap[0];
+        top->heap[0] = top->heap[size];
+        top->heap[size] = worst;
+        top_k_sift_down(top->heap, size);
+    }
+    top->size = 0;
+    return n;
+}
@@ -0,0 +1,99 @@
+#ifndef TOP_K_H
+#define TOP_K_H
+
+/// @file top_k.h
+/// @brief Bounded heap keeping the k best rows of a scan : entries are (key, row) pairs, the best
+/// ones have the biggest key, then the smallest row. The root of the heap is the worst kept entry,
+/// so a scan over n rows costs O(n log k), and most rows are rejected with a single comparison
+/// once the heap is full.\n
+/// Keys are unsigned integers : floats are turned into keys of the same order with
+/// float_to_ordered_key (and complemented to keep the smallest floats instead).
+
+#include <assert.h>
+#include <stdbool.h>
+#include <string.h>
+
+/// @brief An entry of a top k heap
+typedef struct top_k_entry
+{
+    unsigned int key; //!< Rank of the entry (the biggest keys are kept)
+    int row;          //!< Row of the entry, the smallest row wins between equal keys
+} Top_k_entry;
+
+/// @brief Bounded heap of the k best entries pushed in it
+typedef struct top_k
+{
+    ///@brief the entries, a heap whose root is the worst entry (k elements allocated)
+    Top_k_entry *heap;
+    ///@brief number of entries in the heap
+    int size;
+    ///@brief maximum number of entries kept
+    int k;
+} Top_k;
+
+/// @brief Map a float to an unsigned key of the same order (-0 and +0 get the same key)
+/// @param val the float (not NaN)
+/// @return the key
+static inline unsigned int float_to_ordered_key(float val)
+{
+    val += 0.0f; // turns -0 into +0
+    unsigned int bits = 0;
+    memcpy(&bits, &val, sizeof(bits));
+    // negative floats are ordered backward : flip them, and put the positive ones above (no
+    // branch, the key is computed for every row of the scans)
+    unsigned int sign = (unsigned int)((int)bits >> 31);
+    return bits ^ (sign | 0x80000000u);
+}
+
+/// @brief Create an empty top k heap
+/// @param k the maximum number of entries kept (0 keeps nothing)
+/// @return the allocated heap
+Top_k *init_top_k(int k);
+
+/// @brief Free a top k heap
+/// @param top the heap to free
+void free_top_k(Top_k *top);
+
+/// @brief Check if an entry ranks below another one
+/// @return true if a is worse than b (smaller key, or same key and bigger row)
+static inline bool top_k_entry_is_worse(Top_k_entry a, Top_k_entry b)
+{
+    return a.key < b.key || (a.key == b.key && a.row > b.row);
+}
+
+/// @brief Move down the root of a heap of size entries to its place
+void top_k_sift_down(Top_k_entry *heap, int size);
+
+/// @brief Offer an entry to a top k heap : it is kept if it is among the k best so far
+/// @param top the heap
+/// @param key the key of the entry
+/// @param row the row of the entry
+static inline void top_k_push(Top_k *top, unsigned int key, int row)
+{
+    Top_k_entry entry = {.key = key, .row = row};
+    if (top->size == top->k) // full : most entries are rejected here
+    {
+        if (top->k == 0 || !top_k_entry_is_worse(top->heap[0], entry))
+        {
+            return;
+        }
+        top->heap[0] = entry; // replace the worst
+        top_k_sift_down(top->heap, top->size);
+        return;
+    }
+    int i = top->size++; // sift up
+    while (i > 0 && top_k_entry_is_worse(entry, top->heap[(i - 1) / 2]))
+    {
+        top->heap[i] = top->heap[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    top->heap[i] = entry;
+}
+
+/// @brief Sort the entries of a top k heap from the best to the worst. The heap is emptied (its
+/// size is set to 0), the sorted entries stay in top->heap.
+/// @param top the heap
+/// @return the number of sorted entries in top->heap
+int top_k_sort(Top_k *top);
+
+#endif
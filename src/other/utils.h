@@ -91,6 +91,21 @@ size_t bin_read_string(FILE *file, char buf[], long buf_size);
         }                                                                                          \
     } while (0)
 
+/// @brief Hash a string (FNV-1a)
+/// @param str the string (does not need to be null terminated)
+/// @param len the length of the string
+/// @return the hash of the string
+static inline unsigned int hash_string(const char *str, size_t len)
+{
+    unsigned int hash = 2166136261u;
+    for (size_t i = 0; i < len; i++)
+    {
+        hash ^= (unsigned char)str[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
 /// @brief Print a float value with 2 decimals
 /// Used as a callback for Grades_print
 /// @param val the float to print
@@ -2,12 +2,17 @@
 #include "core/cipher.h"
 #include "core/load_bin.h"
 #include "core/load_data.h"
+#include "core/load_mmap.h"
 #include "core/save_bin.h"
 #include "other/project_info.h"
 
 CLASS_DATA *API_load_students(char *file_path)
 {
     assert(file_path);
+#ifndef LOAD_WITH_STDIO
+    // parse the file directly from a read-only memory mapping (see load_mmap.h)
+    return mmap_load_promotion(file_path);
+#else
     FILE *file = fopen(file_path, "r");
     if (file == NULL)
     {
@@ -21,20 +26,30 @@ CLASS_DATA *API_load_students(char *file_path)
     // read first section from file
     // Get to the title of the first part
     set_cursor_to_next_section(sections[0], file);
-    StudentsTab *stu_dtab = load_student_tab_data(file);
+    Arena *arena = init_arena(0);
+    String_pool *names = init_string_pool(arena, 0);
+    StudentsTab *stu_dtab = load_student_tab_data(file, arena, names);
 
     // read second section from file
     set_cursor_to_next_section(sections[1], file);
     CoursesTab *courses = load_courses_data(file);
 
-    allocate_students_courses(stu_dtab, courses->size); // allocate the proper grades dynamic tables
-                                                        // (size supposed const for simplicity)
+    // allocate the proper grades dynamic tables (size supposed const for simplicity)
+    allocate_students_courses(stu_dtab, courses->size, arena);
     // read last section from file
     set_cursor_to_next_section(sections[2], file);
-    Promotion *prom = init_promotion(courses, stu_dtab);
+    Promotion *prom = init_promotion(courses, stu_dtab, arena, names);
     load_grades_data(prom, file);
     fclose(file);
     return prom;
+#endif
+}
+
+int API_apply_grades(CLASS_DATA *pClass, char *file_path)
+{
+    Promotion *prom = (Promotion *)pClass;
+    assert(promotion_is_valid(prom) && file_path);
+    return mmap_apply_grades(prom, file_path);
 }
 
 int API_save_to_binary_file(CLASS_DATA *pClass, char *file_path)
@@ -62,10 +77,14 @@ CLASS_DATA *API_restore_from_binary_file(char *file_path)
     }
     CoursesTab *cr_dtab = CoursesTab_load_from_bin(file, bin_load_course);
     assert(CoursesTab_is_valid(cr_dtab, course_is_valid));
-    StudentsTab *stu_dtab = StudentsTab_load_from_bin(file, bin_load_student);
+    Arena *arena = init_arena(0);
+    String_pool *names = init_string_pool(arena, 0);
+    StudentsTab *stu_dtab = bin_load_student_tab(file, arena, names);
 
     assert(StudentsTab_is_valid(stu_dtab, student_is_valid));
-    Promotion *prom = init_promotion(cr_dtab, stu_dtab);
+    Promotion *prom = init_promotion(cr_dtab, stu_dtab, arena, names);
+    // validation bitmasks and running sums aren't saved : evaluate them again
+    evaluate_all_student_average(prom);
     fclose(file);
     return prom;
 }
@@ -89,27 +108,175 @@ void API_display_results_per_field(CLASS_DATA *pClass)
 
 void API_unload(CLASS_DATA *pClass) { free_promotion(pClass, free_student, free_course); }
 
+/// @brief Get the names of the students of a table, and free the table (not the students)
+/// @param stu_dtab the table
+/// @param size receives the number of names, can be NULL
+/// @return the names (see get_students_names_and_fname)
+static char **students_names_and_free(StudentsTab *stu_dtab, int *size)
+{
+    assert(StudentsTab_is_valid(stu_dtab, student_is_valid));
+    if (size)
+    {
+        *size = stu_dtab->size;
+    }
+    char **names = get_students_names_and_fname(stu_dtab->tab, stu_dtab->size);
+    StudentsTab_free(stu_dtab, NULL);
+    return names;
+}
+
 char **API_get_best_students(CLASS_DATA *pClass)
+{
+    int size = 0;
+    return API_get_best_students_n(pClass, SIZE_TOP1, &size);
+}
+
+char **API_get_best_students_n(CLASS_DATA *pClass, int k, int *size)
 {
     Promotion *prom = (Promotion *)pClass;
-    assert(promotion_is_valid(prom));
-    StudentsTab *stu_dtab = get_top_students(prom->stu_dtab, SIZE_TOP1);
-    assert(stu_dtab);
-    return get_students_names_and_fname(stu_dtab->tab, stu_dtab->size);
+    assert(promotion_is_valid(prom) && k > -1 && size);
+    return students_names_and_free(get_top_students(prom, k), size);
+}
+
+char **API_get_worst_students_n(CLASS_DATA *pClass, int k, int *size)
+{
+    Promotion *prom = (Promotion *)pClass;
+    assert(promotion_is_valid(prom) && k > -1 && size);
+    return students_names_and_free(get_bottom_students(prom, k), size);
 }
 
 char **API_get_best_students_in_course(CLASS_DATA *pClass, char *course)
 {
-    assert(course);
+    int size = 0;
+    return API_get_best_students_in_course_n(pClass, course, SIZE_TOP2, &size);
+}
+
+char **API_get_best_students_in_course_n(CLASS_DATA *pClass, char *course, int k, int *size)
+{
+    assert(course && k > -1 && size);
     assert(promotion_is_valid(pClass));
-    StudentsTab *stu_dtab = get_top_students_in_course(pClass, course, SIZE_TOP2);
+    StudentsTab *stu_dtab = get_top_students_in_course(pClass, course, k);
     if (!stu_dtab)
     {
         fprintf(stderr, BOLD_RED "Course ID not found\n" RESET);
+        *size = 0;
         return NULL;
     }
-    assert(StudentsTab_is_valid(stu_dtab, student_is_valid));
-    return get_students_names_and_fname(stu_dtab->tab, stu_dtab->size);
+    return students_names_and_free(stu_dtab, size);
+}
+
+char ***API_get_best_students_all_courses(CLASS_DATA *pClass, int k)
+{
+    Promotion *prom = (Promotion *)pClass;
+    assert(promotion_is_valid(prom) && k > -1);
+    StudentsTab **tops = get_top_students_all_courses(prom, k);
+    int n_courses = prom->courses->size;
+    char ***names = (char ***)malloc((n_courses > 0 ? n_courses : 1) * sizeof(char **));
+    verify(names, "malloc error");
+    for (int i = 0; i < n_courses; i++)
+    {
+        names[i] = students_names_and_free(tops[i], NULL);
+    }
+    free(tops);
+    return names;
+}
+
+char *API_get_student_by_id(CLASS_DATA *pClass, unsigned int id)
+{
+    Promotion *prom = (Promotion *)pClass;
+    assert(prom && prom->stu_index);
+    Student *stu = student_index_find(prom->stu_index, id);
+    if (!stu)
+    {
+        return NULL;
+    }
+    char **names = get_students_names_and_fname(&stu, 1);
+    char *name = names[0];
+    free(names);
+    return name;
+}
+
+int API_count_validated_students(CLASS_DATA *pClass, unsigned int courses_mask)
+{
+    Promotion *prom = (Promotion *)pClass;
+    assert(promotion_is_valid(prom));
+    return count_students_validated(prom, courses_mask);
+}
+
+char **API_get_validated_students(CLASS_DATA *pClass, unsigned int courses_mask, int *size)
+{
+    Promotion *prom = (Promotion *)pClass;
+    assert(promotion_is_valid(prom) && size);
+    StudentsTab *stu_dtab = get_students_validated(prom, courses_mask);
+    return students_names_and_free(stu_dtab, size);
+}
+
+void API_display_validation_summary(CLASS_DATA *pClass)
+{
+    Promotion *prom = (Promotion *)pClass;
+    assert(promotion_is_valid(prom));
+    Validation_summary summary = get_validation_summary(prom);
+    printf(BOLD_CYN UNDERLINE "Validation of %d students:\n" RESET, summary.n_students);
+    printf("OO - every course validated: %d\n", summary.year);
+    printf("O" RED "X" RESET " - only humanities validated: %d\n",
+           summary.humanities - summary.year);
+    printf(RED "X" RESET "O - only sciences validated: %d\n", summary.sciences - summary.year);
+    printf(RED "XX - humanities and science not validated: %d\n" RESET, summary.none);
+    printf(BOLD_BLU "\n-------------\n" RESET);
+    for (int i = 0; i < prom->courses->size; i++)
+    {
+        printf("%s: %d\n", prom->courses->tab[i]->name,
+               count_students_validated(prom, (__uint32_t)1 << i));
+    }
+}
+
+COURSE_STATS *API_course_stats(CLASS_DATA *pClass, int *n_courses)
+{
+    Promotion *prom = (Promotion *)pClass;
+    assert(promotion_is_valid(prom) && n_courses);
+    Course_stats *stats = get_courses_stats(prom);
+    int n = prom->courses->size;
+    COURSE_STATS *tab = (COURSE_STATS *)malloc((n > 0 ? n : 1) * sizeof(COURSE_STATS));
+    verify(tab, "malloc error");
+    for (int i = 0; i < n; i++)
+    {
+        const Course_stats *course = &stats[i];
+        tab[i] = (COURSE_STATS){.course = prom->courses->tab[i]->name,
+                                .count = course->count,
+                                .mean = course->mean,
+                                .variance = course->variance,
+                                .min = course->min,
+                                .max = course->max,
+                                .pass_rate = course_stats_pass_rate(course),
+                                .median = course_stats_percentile(course, 50),
+                                .percentile_10 = course_stats_percentile(course, 10),
+                                .percentile_25 = course_stats_percentile(course, 25),
+                                .percentile_75 = course_stats_percentile(course, 75),
+                                .percentile_90 = course_stats_percentile(course, 90)};
+    }
+    free(stats);
+    *n_courses = n;
+    return tab;
+}
+
+char *API_get_weakest_course(CLASS_DATA *pClass, unsigned int id, float *average)
+{
+    Promotion *prom = (Promotion *)pClass;
+    assert(prom && prom->stu_index && prom->courses);
+    Student *stu = student_index_find(prom->stu_index, id);
+    if (!stu || stu->weakest_course == -1)
+    {
+        return NULL;
+    }
+    assert(stu->weakest_course < prom->courses->size);
+    if (average)
+    {
+        *average = stu->min_course_avg;
+    }
+    const char *course_name = prom->courses->tab[stu->weakest_course]->name;
+    char *name = (char *)malloc((strlen(course_name) + 1) * sizeof(char));
+    verify(name, "malloc error");
+    strcpy(name, course_name);
+    return name;
 }
 
 int API_set_sorting_mode(CLASS_DATA *pClass, int mode)
@@ -143,11 +310,17 @@ int API_set_sorting_mode(CLASS_DATA *pClass, int mode)
 
 char **API_sort_students(CLASS_DATA *pClass)
 {
-    assert(promotion_is_valid(pClass));
+    return API_sort_students_n(pClass, SIZE_TOP1);
+}
+
+char **API_sort_students_n(CLASS_DATA *pClass, int k)
+{
+    assert(promotion_is_valid(pClass) && k > -1);
     Promotion *prom = (Promotion *)pClass;
-    StudentsTab *stu_dtab = prom->stu_dtab;
-    StudentsTab_sort(stu_dtab, prom->compare_student);
-    return get_students_names_and_fname(stu_dtab->tab, SIZE_TOP1);
+    // never more names than sorted students (the cached permutation has size elements)
+    k = k < prom->stu_dtab->size ? k : prom->stu_dtab->size;
+    // the students table stays in id order, the sorted permutation is cached by the promotion
+    return get_students_names_and_fname(get_first_sorted_students(prom, k), k);
 }
 
 int API_cipher(char *pIn, char *pOut)